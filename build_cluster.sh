@@ -3,7 +3,6 @@
 module load \
   llvm/9.0.0 \
   gcc/9.2.0 \
-  boost/1.72.0 \
   intel/19.0.5 \
   cmake || exit
 
@@ -22,4 +21,4 @@ cmake -DCMAKE_BUILD_TYPE=Release \
 
 cd ..
 cmake --build cmake-build-remote-release/ --target bench_throughput -- -j 1
-module unload cmake intel boost gcc llvm
+module unload cmake intel gcc llvm
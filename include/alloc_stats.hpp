@@ -0,0 +1,63 @@
+#ifndef LOO_QUEUE_BENCHES_ALLOC_STATS_HPP
+#define LOO_QUEUE_BENCHES_ALLOC_STATS_HPP
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+
+/**
+ * Optional accounting of all heap allocations of the bench threads, which is
+ * only compiled in if `ALLOC_STATS` is defined (CMake option `ALLOC_STATS`).
+ *
+ * The allocation functions (`malloc`, `operator new` and their relatives) are
+ * intercepted with the linker's `--wrap` option and passed on to whichever
+ * allocator provides them, so the accounting works alike for the system
+ * allocator, mimalloc and rpmalloc. Sizes are the allocator's usable sizes
+ * (`malloc_usable_size`), i.e., including its rounding to size classes.
+ *
+ * Each thread counts into its own thread-local counters, which are added to
+ * the global totals in batches, so the peak of live bytes is only exact up to
+ * one batch (`FLUSH_BYTES`) per thread. The bench threads flush their counters
+ * (cf. `flush_thread`) after each run, threads which do not may leave up to
+ * one batch uncounted. Without `ALLOC_STATS`, all functions do nothing.
+ */
+namespace alloc {
+/** the number of bytes a thread's live bytes may drift before it adds its
+ *  counters to the totals */
+constexpr std::int64_t FLUSH_BYTES = 64 * 1024;
+
+/** the columns appended by `print_totals` */
+constexpr std::array<std::string_view, 6> COLUMN_NAMES{
+    "allocs",
+    "frees",
+    "alloc_bytes",
+    "peak_live_bytes",
+    "peak_rss_kb",
+    "alloc_bytes_per_op",
+};
+
+#ifdef ALLOC_STATS
+/** resets all totals and the process' peak RSS, must be called before the
+ *  queue of a run is constructed */
+void begin_run();
+
+/** adds the calling thread's counters to the totals right away */
+void flush_thread() noexcept;
+
+/** appends the totals since the last call to `begin_run` as columns: the
+ *  number of allocations and frees, the allocated bytes, the peak of live
+ *  bytes above those live at the start of the run, the peak RSS (in KiB) and
+ *  the allocated bytes per operation (of `total_ops`) */
+void print_totals(std::ostream& os, std::size_t total_ops);
+#else
+inline void begin_run() {}
+inline void flush_thread() noexcept {}
+inline void print_totals(std::ostream& os, std::size_t total_ops) {
+  static_cast<void>(os);
+  static_cast<void>(total_ops);
+}
+#endif
+}
+
+#endif /* LOO_QUEUE_BENCHES_ALLOC_STATS_HPP */
@@ -1,28 +1,189 @@
 #ifndef LOO_QUEUE_BENCHES_COMMON_HPP
 #define LOO_QUEUE_BENCHES_COMMON_HPP
 
+#include <span>
+#include <string>
 #include <string_view>
+#include <vector>
 
 namespace bench {
-enum class bench_type_t { PAIRS, BURSTS, READS, WRITES, MIXED };
-enum class queue_type_t { LCR, LOO, FAA, FAA_V1, FAA_V2, FAA_V3, MSC, SCQ2, SCQD, YMC };
+enum class bench_type_t { PAIRS, BURSTS, READS, WRITES, MIXED, RANK, SPSC, MPSC, LATENCY, BULK, SIZE, NOTIFY, ASYNC, FORKJOIN, PIPELINE, OPENLOOP };
+enum class queue_type_t { LCR, LOO, FAA, FAA_V1, FAA_V2, FAA_V3, MSC, SCQ2, SCQD, YMC, FC, MTX, TLQ, TKT, SHD, SHD_LCR, SPSC, MPSC, KPQ, HRQ };
 
 constexpr std::string_view display_str(queue_type_t queue) {
   switch (queue) {
-    case queue_type_t::LCR:    return "LCR";
-    case queue_type_t::LOO:    return "LOO";
-    case queue_type_t::FAA:    return "FAA";
-    case queue_type_t::FAA_V1: return "FAA (variant 1)";
-    case queue_type_t::FAA_V2: return "FAA (variant 2)";
-    case queue_type_t::FAA_V3: return "FAA (variant 3)";
-    case queue_type_t::MSC:    return "MSC";
-    case queue_type_t::SCQ2:   return "LSCQ2";
-    case queue_type_t::SCQD:   return "LSCQD";
-    case queue_type_t::YMC:    return "YMC";
-    default:                   return "unknown";
+    case queue_type_t::LCR:     return "LCR";
+    case queue_type_t::LOO:     return "LOO";
+    case queue_type_t::FAA:     return "FAA";
+    case queue_type_t::FAA_V1:  return "FAA (variant 1)";
+    case queue_type_t::FAA_V2:  return "FAA (variant 2)";
+    case queue_type_t::FAA_V3:  return "FAA (variant 3)";
+    case queue_type_t::MSC:     return "MSC";
+    case queue_type_t::SCQ2:    return "LSCQ2";
+    case queue_type_t::SCQD:    return "LSCQD";
+    case queue_type_t::YMC:     return "YMC";
+    case queue_type_t::FC:      return "FC";
+    case queue_type_t::MTX:     return "MTX";
+    case queue_type_t::TLQ:     return "TLQ";
+    case queue_type_t::TKT:     return "TKT";
+    case queue_type_t::SHD:     return "SHD";
+    case queue_type_t::SHD_LCR: return "SHD (LCR)";
+    case queue_type_t::SPSC:    return "SPSC";
+    case queue_type_t::MPSC:    return "MPSC";
+    case queue_type_t::KPQ:     return "KPQ";
+    case queue_type_t::HRQ:     return "HRQ";
+    default:                    return "unknown";
   }
 }
 
+constexpr std::string_view display_str(bench_type_t bench) {
+  switch (bench) {
+    case bench_type_t::PAIRS:    return "pairs";
+    case bench_type_t::BURSTS:   return "bursts";
+    case bench_type_t::READS:    return "reads";
+    case bench_type_t::WRITES:   return "writes";
+    case bench_type_t::MIXED:    return "mixed";
+    case bench_type_t::RANK:     return "rank";
+    case bench_type_t::SPSC:     return "spsc";
+    case bench_type_t::MPSC:     return "mpsc";
+    case bench_type_t::LATENCY:  return "latency";
+    case bench_type_t::BULK:     return "bulk";
+    case bench_type_t::SIZE:     return "size";
+    case bench_type_t::NOTIFY:   return "notify";
+    case bench_type_t::ASYNC:    return "async";
+    case bench_type_t::FORKJOIN: return "forkjoin";
+    case bench_type_t::PIPELINE: return "pipeline";
+    case bench_type_t::OPENLOOP: return "openloop";
+    default:                     return "unknown";
+  }
+}
+
+/** one stage of the `pipeline` bench, the first stage produces all elements and
+ *  the last consumes them */
+struct pipeline_stage_t {
+  std::size_t threads;
+  /** time spent (spinning) on each element before passing it on */
+  std::size_t work_ns;
+};
+
+/** placement of the producer and consumer threads on the (consecutively
+ *  numbered) cores */
+enum class role_placement_t { INTERLEAVED, GROUPED };
+
+/** the order in which the threads are pinned to the CPUs */
+enum class affinity_t {
+  /** thread `i` on the `i`-th online CPU, regardless of the topology */
+  LINEAR,
+  /** fills one package (socket) after another, first one thread per core */
+  COMPACT,
+  /** spreads the threads round-robin across the packages */
+  SCATTER,
+  /** one thread per core of all packages before using any SMT sibling */
+  CORES,
+  /** fills all SMT siblings of one core before using the next core */
+  SMT,
+  /** the CPUs given with `--cpus` */
+  LIST
+};
+
+constexpr std::string_view display_str(affinity_t affinity) {
+  switch (affinity) {
+    case affinity_t::LINEAR:  return "linear";
+    case affinity_t::COMPACT: return "compact";
+    case affinity_t::SCATTER: return "scatter";
+    case affinity_t::CORES:   return "cores";
+    case affinity_t::SMT:     return "smt";
+    case affinity_t::LIST:    return "list";
+    default:                  return "unknown";
+  }
+}
+
+/** the schedule of the producers' send times in the `openloop` bench */
+enum class arrival_t { FIXED, POISSON };
+
+/** the distribution of the think time each thread spends (spinning) after
+ *  each of its operations */
+enum class think_dist_t { NONE, FIXED, UNIFORM, EXPONENTIAL, BIMODAL };
+
+/** the think time between two operations of a thread, in nanoseconds */
+struct think_time_t {
+  think_dist_t dist{ think_dist_t::NONE };
+  /** the fixed, minimum (uniform), mean (exponential) or short (bimodal) time */
+  std::size_t  first_ns{ 0 };
+  /** the maximum (uniform) or long (bimodal) time */
+  std::size_t  second_ns{ 0 };
+  /** the percentage of long times (bimodal) */
+  std::size_t  long_percent{ 0 };
+};
+
+/** the file format of the results written with `--output` */
+enum class output_format_t { CSV, JSON };
+
+/** two relative weights, e.g., a producer to consumer ratio */
+struct weights_t {
+  std::size_t first{ 0 };
+  std::size_t second{ 0 };
+
+  [[nodiscard]] bool empty() const noexcept { return this->first == 0 && this->second == 0; }
+};
+
+/** optional `--key=value` program arguments following the positional ones */
+struct options_t {
+  /** `--stages=<threads>[:<work_ns>]/...`, empty if not given */
+  std::vector<pipeline_stage_t> stages{};
+  /** `--latency=<n>`, times every n-th operation of the pairs, bursts, reads,
+   *  writes and mixed benches, 0 disables all timing */
+  std::size_t latency_interval{ 0 };
+  /** `--duration=<ms>`, runs each thread until the time is up instead of for a
+   *  fixed number of operations, 0 disables the fixed-duration mode */
+  std::size_t duration_ms{ 0 };
+  /** `--roles=<P>:<C>`, ratio of producer to consumer threads in the reads,
+   *  writes and mixed benches, empty to use each bench's default ratio */
+  weights_t roles{};
+  /** `--mix=<E>/<D>`, lets every thread of the reads, writes and mixed benches
+   *  enqueue or dequeue at random with the given weights instead */
+  weights_t mix{};
+  /** `--placement=interleaved|grouped`, spreads the threads of each role
+   *  evenly or places all producers on the lowest numbered cores */
+  role_placement_t placement{ role_placement_t::INTERLEAVED };
+  /** `--rate=<n>`, aggregate number of elements per second offered by the
+   *  producers of the `openloop` bench, 0 to sweep fractions of the measured
+   *  saturation throughput instead */
+  std::size_t rate{ 0 };
+  /** `--arrival=fixed|poisson`, spaces each producer's send times in the
+   *  `openloop` bench evenly or exponentially distributed */
+  arrival_t arrival{ arrival_t::FIXED };
+  /** `--think=fixed:<ns>|uniform:<min>-<max>|exp:<mean>|bimodal:<short>/<long>:<%long>`,
+   *  spins each thread for a random think time after each of its operations,
+   *  drawn from the given distribution with a PRNG of its own */
+  think_time_t think{};
+  /** `--thread-stats=on|off`, appends the fairness index, the minimum and
+   *  maximum thread rates, the start and stop skew and each thread's number
+   *  of operations, empty dequeues and elapsed time to every run's line of
+   *  output */
+  bool thread_stats{ false };
+  /** `--perf=on|off`, counts the events in `bench::PERF_EVENTS` and context
+   *  switches for each thread between the start and stop barriers and appends
+   *  their totals per operation to every run's line of output */
+  bool perf_counters{ false };
+  /** `--warmup=<runs>`, executes as many runs before the measured runs of
+   *  each thread count, whose output is discarded */
+  std::size_t warmup{ 0 };
+  /** `--affinity=linear|compact|scatter|cores|smt`, the order in which the
+   *  threads are pinned to the CPUs (`list` if `--cpus` is given) */
+  affinity_t affinity{ affinity_t::LINEAR };
+  /** `--cpus=<list>`, the CPUs (e.g., "0-7,16-23") the threads are pinned to
+   *  in the given order */
+  std::vector<std::size_t> cpus{};
+  /** `--output=<path>`, additionally writes all measurements, the metadata of
+   *  the host and build and a summary across all runs to the file, empty to
+   *  only print to stdout */
+  std::string output{};
+  /** `--format=csv|json`, the format of the `--output` file, by default JSON
+   *  if its name ends in `.json` and CSV otherwise */
+  output_format_t format{ output_format_t::CSV };
+};
+
 /** parses the given string to the corresponding queue type */
 queue_type_t parse_queue_str(std::string_view queue);
 /** parses the given string to the corresponding bench type */
@@ -31,7 +192,21 @@ bench_type_t parse_bench_str(std::string_view bench);
 std::size_t  parse_total_ops_str(std::string_view total_ops);
 /** parses the benchmark `runs` argument string */
 std::size_t  parse_runs_str(std::string_view runs);
-/** pins the thread with the given id to the core with the same number */
+/** parses the `--stages` option string */
+std::vector<pipeline_stage_t> parse_pipeline_str(std::string_view stages);
+/** parses the `--think` option string */
+think_time_t parse_think_str(std::string_view think);
+/** parses all optional arguments */
+options_t    parse_options(std::span<char* const> args);
+/** returns the CPUs in the order in which the threads are pinned to them
+ *  with the given options, as read from sysfs */
+std::vector<std::size_t> affinity_cpus(const options_t& options);
+/** returns the maximum number of threads that can be pinned with the given
+ *  options without sharing a core, unless the policy itself uses SMT siblings
+ *  (`compact`, `smt` and `list`) */
+std::size_t max_threads(const options_t& options);
+/** pins the thread with the given id to its CPU (cf. `topology::cpu_of_thread`),
+ *  which is the CPU with the same number, unless set otherwise */
 void pin_current_thread(std::size_t thread_id);
 /** spins the current thread for at least `ns` nanoseconds */
 void spin_for_ns(std::size_t ns);
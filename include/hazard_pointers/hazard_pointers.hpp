@@ -5,6 +5,8 @@
 
 #include <stdexcept>
 
+#include "queue_events.hpp"
+
 namespace memory {
 template<typename T>
 hazard_pointers<T>::hazard_pointers(
@@ -89,6 +91,7 @@ void hazard_pointers<T>::retire(hazard_pointers::pointer ptr, std::size_t thread
     return;
   }
 
+  QUEUE_EVENT(HP_SCAN);
   std::size_t curr = 0;
   while (curr < thread_retired_objects.size()) {
     const auto retired = thread_retired_objects[curr];
@@ -100,6 +103,7 @@ void hazard_pointers<T>::retire(hazard_pointers::pointer ptr, std::size_t thread
 
       thread_retired_objects.pop_back();
       delete retired;
+      QUEUE_EVENT(HP_RECLAIMED);
       continue;
     }
 
@@ -0,0 +1,174 @@
+#ifndef LOO_QUEUE_BENCHES_HISTOGRAM_HPP
+#define LOO_QUEUE_BENCHES_HISTOGRAM_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+
+#include <x86intrin.h>
+
+#include "looqueue/align.hpp"
+
+namespace bench {
+/** reads the time stamp counter, after all preceding instructions completed */
+inline std::uint64_t rdtsc() noexcept {
+  _mm_lfence();
+  return __rdtsc();
+}
+
+/** returns the (once measured) duration of one time stamp counter cycle */
+inline double ns_per_cycle() {
+  static const auto NS_PER_CYCLE = [] {
+    using clock = std::chrono::steady_clock;
+    constexpr std::chrono::milliseconds CALIBRATION_TIME{ 20 };
+
+    const auto start = clock::now();
+    const auto start_cycles = rdtsc();
+    while (clock::now() - start < CALIBRATION_TIME) {}
+    const auto stop_cycles = rdtsc();
+    const std::chrono::nanoseconds elapsed = clock::now() - start;
+
+    return static_cast<double>(elapsed.count()) / static_cast<double>(stop_cycles - start_cycles);
+  }();
+
+  return NS_PER_CYCLE;
+}
+
+/**
+ * Log-linear histogram (like HdrHistogram) of 64-bit values.
+ *
+ * Values below `2^SUB_BITS` are counted exactly, larger values in one of
+ * `2^SUB_BITS` linear sub-buckets per power of two, i.e., with a relative
+ * error of at most `2^-SUB_BITS`. All buckets are allocated up front, so
+ * recording never allocates.
+ */
+class alignas(CACHE_LINE_ALIGN) histogram {
+public:
+  static constexpr std::size_t SUB_BITS = 5;
+
+  void record(std::uint64_t value) noexcept {
+    this->m_counts[bucket_of(value)] += 1;
+    this->m_total += 1;
+    this->m_max = std::max(this->m_max, value);
+  }
+
+  void merge(const histogram& other) noexcept {
+    for (std::size_t idx = 0; idx < BUCKETS; ++idx) {
+      this->m_counts[idx] += other.m_counts[idx];
+    }
+
+    this->m_total += other.m_total;
+    this->m_max = std::max(this->m_max, other.m_max);
+  }
+
+  void reset() noexcept {
+    this->m_counts.fill(0);
+    this->m_total = 0;
+    this->m_max = 0;
+  }
+
+  /** returns the highest value equivalent to the value at the percentile */
+  [[nodiscard]] std::uint64_t percentile(double pct) const noexcept {
+    if (this->m_total == 0) {
+      return 0;
+    }
+
+    const auto rank = static_cast<std::uint64_t>(pct / 100.0 * static_cast<double>(this->m_total - 1)) + 1;
+    std::uint64_t seen = 0;
+    for (std::size_t idx = 0; idx < BUCKETS; ++idx) {
+      seen += this->m_counts[idx];
+      if (seen >= rank) {
+        return std::min(highest_of(idx), this->m_max);
+      }
+    }
+
+    return this->m_max;
+  }
+
+  [[nodiscard]] std::uint64_t max() const noexcept { return this->m_max; }
+  [[nodiscard]] std::uint64_t count() const noexcept { return this->m_total; }
+
+private:
+  static constexpr std::size_t SUB_COUNT = std::size_t{ 1 } << SUB_BITS;
+  static constexpr std::size_t BUCKETS = (64 - SUB_BITS + 1) * SUB_COUNT;
+
+  static std::size_t bucket_of(std::uint64_t value) noexcept {
+    if (value < SUB_COUNT) {
+      return value;
+    }
+
+    const auto shift = static_cast<std::size_t>(std::bit_width(value)) - 1 - SUB_BITS;
+    return (shift + 1) * SUB_COUNT + ((value >> shift) - SUB_COUNT);
+  }
+
+  static std::uint64_t highest_of(std::size_t bucket) noexcept {
+    if (bucket < SUB_COUNT) {
+      return bucket;
+    }
+
+    const auto shift = bucket / SUB_COUNT - 1;
+    const auto lowest = static_cast<std::uint64_t>(bucket % SUB_COUNT + SUB_COUNT) << shift;
+    return lowest + ((std::uint64_t{ 1 } << shift) - 1);
+  }
+
+  std::array<std::uint64_t, BUCKETS> m_counts{ };
+  std::uint64_t                      m_total{ 0 };
+  std::uint64_t                      m_max{ 0 };
+};
+
+/**
+ * Times every `interval`-th operation in cycles and records it in a histogram.
+ *
+ * The disabled specialization does nothing, so code instantiated with it is
+ * identical to code without any timing.
+ */
+template <bool ENABLED>
+class op_timer {
+public:
+  explicit op_timer(std::size_t interval) : m_interval{ interval }, m_countdown{ interval } {}
+
+  /** returns the start timestamp or 0, if the operation is not sampled */
+  std::uint64_t start() noexcept {
+    if (--this->m_countdown != 0) {
+      return 0;
+    }
+
+    this->m_countdown = this->m_interval;
+    return rdtsc();
+  }
+
+  void stop(histogram& hist, std::uint64_t start) noexcept {
+    if (start != 0) {
+      hist.record(rdtsc() - start);
+    }
+  }
+
+private:
+  const std::size_t m_interval;
+  std::size_t       m_countdown;
+};
+
+template <>
+class op_timer<false> {
+public:
+  explicit op_timer(std::size_t) noexcept {}
+
+  std::uint64_t start() noexcept { return 0; }
+  void stop(histogram&, std::uint64_t) noexcept {}
+};
+
+/** calls `fn` with an enabled timer, if `interval` is not 0, otherwise with a
+ *  disabled one */
+template <typename F>
+void with_op_timer(std::size_t interval, F&& fn) {
+  if (interval == 0) {
+    fn(op_timer<false>{ 0 });
+  } else {
+    fn(op_timer<true>{ interval });
+  }
+}
+}
+
+#endif /* LOO_QUEUE_BENCHES_HISTOGRAM_HPP */
@@ -0,0 +1,76 @@
+#ifndef LOO_QUEUE_BENCHMARK_SPINLOCK_HPP
+#define LOO_QUEUE_BENCHMARK_SPINLOCK_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+#include <x86intrin.h>
+
+#include "looqueue/align.hpp"
+
+namespace locks {
+/** waiting threads only fall back to yielding after this many iterations, so
+ *  that runs with more threads than CPUs still make progress (as with
+ *  `bench::spin_barrier`, but sooner, since a preempted lock holder or next
+ *  ticket stalls every waiting thread on each hand-off of the lock) */
+constexpr std::size_t SPINS_BEFORE_YIELD = 1 << 8;
+
+/** waits once in the spin loop of a lock after `spins` previous iterations */
+inline void spin_wait(std::size_t spins) noexcept {
+  if (spins < SPINS_BEFORE_YIELD) {
+    _mm_pause();
+  } else {
+    std::this_thread::yield();
+  }
+}
+
+/** test-and-test-and-set spin lock (satisfies `BasicLockable`) */
+class ttas_lock final {
+public:
+  void lock() noexcept {
+    for (std::size_t spins = 0; true; ) {
+      if (!this->m_locked.exchange(true, std::memory_order_acquire)) {
+        return;
+      }
+
+      while (this->m_locked.load(std::memory_order_relaxed)) {
+        spin_wait(spins++);
+      }
+    }
+  }
+
+  void unlock() noexcept {
+    this->m_locked.store(false, std::memory_order_release);
+  }
+
+private:
+  std::atomic_bool m_locked{ false };
+};
+
+/** FIFO fair ticket spin lock (satisfies `BasicLockable`) */
+class ticket_lock final {
+public:
+  void lock() noexcept {
+    const auto ticket = this->m_next_ticket.fetch_add(1, std::memory_order_relaxed);
+    for (std::size_t spins = 0; this->m_now_serving.load(std::memory_order_acquire) != ticket; ++spins) {
+      spin_wait(spins);
+    }
+  }
+
+  void unlock() noexcept {
+    // only the lock holder ever writes to `now_serving`
+    const auto curr = this->m_now_serving.load(std::memory_order_relaxed);
+    this->m_now_serving.store(curr + 1, std::memory_order_release);
+  }
+
+private:
+  /** waiting threads spin on `now_serving` and arriving threads increment
+   *  `next_ticket`, so both are kept on separate cache lines */
+  alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> m_next_ticket{ 0 };
+  alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> m_now_serving{ 0 };
+};
+}
+
+#endif /* LOO_QUEUE_BENCHMARK_SPINLOCK_HPP */
@@ -0,0 +1,185 @@
+#ifndef LOO_QUEUE_BENCHES_PERF_COUNTERS_HPP
+#define LOO_QUEUE_BENCHES_PERF_COUNTERS_HPP
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string_view>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace bench {
+/** one hardware event counted by `perf_counters` */
+struct perf_event_t {
+  std::uint32_t    type;
+  std::uint64_t    config;
+  std::string_view name;
+};
+
+namespace detail {
+constexpr std::uint64_t cache_miss_config(std::uint64_t cache) {
+  return cache
+      | (std::uint64_t{ PERF_COUNT_HW_CACHE_OP_READ } << 8)
+      | (std::uint64_t{ PERF_COUNT_HW_CACHE_RESULT_MISS } << 16);
+}
+}
+
+/** the counted events, in the order in which they are printed */
+constexpr std::array<perf_event_t, 5> PERF_EVENTS{{
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, "cycles" },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, "instructions" },
+    { PERF_TYPE_HW_CACHE, detail::cache_miss_config(PERF_COUNT_HW_CACHE_L1D), "L1-dcache-load-misses" },
+    { PERF_TYPE_HW_CACHE, detail::cache_miss_config(PERF_COUNT_HW_CACHE_LL), "LLC-load-misses" },
+    { PERF_TYPE_HW_CACHE, detail::cache_miss_config(PERF_COUNT_HW_CACHE_NODE), "node-load-misses" },
+}};
+
+/**
+ * Group of `PERF_EVENTS` counters for the thread that opens it.
+ *
+ * The counters are only running between `enable` and `disable`, so they can
+ * be limited to exactly the measured section of a bench. Events the hardware
+ * or the `perf_event_paranoid` setting does not permit are left out, if no
+ * event can be opened at all, the group stays empty and reads no values.
+ *
+ * Context switches are counted from the thread's resource usage instead,
+ * since they happen in the kernel, which is excluded from counting by the
+ * default `perf_event_paranoid` setting.
+ */
+class perf_counters {
+public:
+  using values_t = std::array<std::optional<std::uint64_t>, PERF_EVENTS.size()>;
+
+  perf_counters() = default;
+
+  ~perf_counters() noexcept {
+    // if no event could be opened, no descriptor needs to be closed
+    if (this->m_leader == -1) {
+      return;
+    }
+
+    for (const auto fd : this->m_fds) {
+      if (fd != -1) {
+        ::close(fd);
+      }
+    }
+  }
+
+  /** opens the counters for the calling thread, returns false if none could
+   *  be opened */
+  bool open() {
+    // kernel events can only be counted if `perf_event_paranoid` is below 2,
+    // user space events of the own process unless it is above 2
+    static const auto EXCLUDE_KERNEL = [] {
+      int paranoid = 2;
+      std::ifstream file{ "/proc/sys/kernel/perf_event_paranoid" };
+      file >> paranoid;
+      return paranoid >= 2;
+    }();
+
+    for (std::size_t idx = 0; idx < PERF_EVENTS.size(); ++idx) {
+      perf_event_attr attr{};
+      attr.size = sizeof(perf_event_attr);
+      attr.type = PERF_EVENTS[idx].type;
+      attr.config = PERF_EVENTS[idx].config;
+      attr.disabled = this->m_leader == -1 ? 1 : 0;
+      attr.exclude_kernel = EXCLUDE_KERNEL ? 1 : 0;
+      attr.exclude_hv = 1;
+      attr.read_format =
+          PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+      const auto fd = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, this->m_leader, 0));
+      this->m_fds[idx] = fd;
+      if (fd != -1 && this->m_leader == -1) {
+        this->m_leader = fd;
+      }
+    }
+
+    return this->m_leader != -1;
+  }
+
+  void enable() noexcept {
+    this->m_context_switches -= thread_context_switches();
+    if (this->m_leader != -1) {
+      ::ioctl(this->m_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+  }
+
+  void disable() noexcept {
+    if (this->m_leader != -1) {
+      ::ioctl(this->m_leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    }
+    this->m_context_switches += thread_context_switches();
+  }
+
+  /** returns the number of context switches while enabled */
+  [[nodiscard]] std::uint64_t context_switches() const noexcept {
+    return this->m_context_switches;
+  }
+
+  /** returns the value of each opened event, scaled up if the group had to
+   *  share the hardware counters with other groups */
+  [[nodiscard]] values_t read() const {
+    values_t res{};
+    if (this->m_leader == -1) {
+      return res;
+    }
+
+    // nr, time_enabled, time_running, values[nr]
+    std::array<std::uint64_t, 3 + PERF_EVENTS.size()> buf{};
+    if (::read(this->m_leader, buf.data(), sizeof(buf)) <= 0) {
+      return res;
+    }
+
+    const auto enabled = buf[1], running = buf[2];
+    const auto scale = running == 0 ? 0.0 : static_cast<double>(enabled) / static_cast<double>(running);
+
+    // the values are in the order in which the events were added to the group
+    std::size_t value = 3;
+    for (std::size_t idx = 0; idx < PERF_EVENTS.size(); ++idx) {
+      if (this->m_fds[idx] != -1) {
+        res[idx] = static_cast<std::uint64_t>(static_cast<double>(buf[value++]) * scale);
+      }
+    }
+
+    return res;
+  }
+
+  perf_counters(const perf_counters&)            = delete;
+  perf_counters(perf_counters&&)                 = delete;
+  perf_counters& operator=(const perf_counters&) = delete;
+  perf_counters& operator=(perf_counters&&)      = delete;
+
+private:
+  /** returns the calling thread's voluntary and involuntary context switches */
+  static std::uint64_t thread_context_switches() noexcept {
+    rusage usage{};
+    ::getrusage(RUSAGE_THREAD, &usage);
+    return static_cast<std::uint64_t>(usage.ru_nvcsw + usage.ru_nivcsw);
+  }
+
+  int                                 m_leader{ -1 };
+  std::array<int, PERF_EVENTS.size()> m_fds{ };
+  std::uint64_t                       m_context_switches{ 0 };
+};
+
+/** prints a warning (once) that no counters are available */
+inline void warn_perf_unavailable() {
+  static const auto WARNED = [] {
+    std::cerr
+        << "warning: failed to open any performance counter (check "
+        << "/proc/sys/kernel/perf_event_paranoid), printing '-' instead of hardware events"
+        << std::endl;
+    return true;
+  }();
+
+  static_cast<void>(WARNED);
+}
+}
+
+#endif /* LOO_QUEUE_BENCHES_PERF_COUNTERS_HPP */
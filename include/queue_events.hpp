@@ -0,0 +1,121 @@
+#ifndef LOO_QUEUE_BENCHES_QUEUE_EVENTS_HPP
+#define LOO_QUEUE_BENCHES_QUEUE_EVENTS_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+
+/**
+ * Optional counters for events on the hot paths inside the queues, which are
+ * only compiled in if `QUEUE_EVENTS` is defined (CMake option `QUEUE_EVENTS`).
+ *
+ * Each thread counts into its own thread-local counters, which are added to
+ * the global totals once the thread exits, so the totals cover exactly the
+ * threads of one bench run once these have been joined (or have flushed their
+ * counters, cf. `flush_thread`), including the calling thread of
+ * `print_totals`. Without `QUEUE_EVENTS`, the `QUEUE_EVENT` macros expand to
+ * nothing.
+ */
+namespace events {
+enum class event_t : std::size_t {
+  /** `faa::queue`: CAS on a reserved slot failed, since a dequeuer took it */
+  FAILED_SLOT_CAS,
+  /** `faa::queue`: dequeuer abandoned a reserved slot, marking it `TAKEN` */
+  ABANDONED_SLOT,
+  /** `faa::queue`, `lcr::queue`: enqueue or dequeue entered its slow path */
+  SLOW_PATH,
+  /** `faa::queue`, `lcr::queue`: allocated a new node or ring */
+  SEGMENT_ALLOC,
+  /** `faa::queue`, `lcr::queue`: deleted a new node after losing `cas_next` */
+  LOST_CAS_NEXT,
+  /** `lcr::queue`: closed a ring */
+  RING_CLOSE,
+  /** `lcr::queue`: called `fix_state` */
+  FIX_STATE,
+  /** `lcr::queue`: closed a ring, which was not full, after `PATIENCE` attempts */
+  PATIENCE_EXHAUSTED,
+  /** `memory::hazard_pointers`: scanned the retired objects */
+  HP_SCAN,
+  /** `memory::hazard_pointers`: reclaimed a retired object during a scan */
+  HP_RECLAIMED,
+  COUNT
+};
+
+constexpr std::size_t EVENT_COUNT = static_cast<std::size_t>(event_t::COUNT);
+
+constexpr std::array<std::string_view, EVENT_COUNT> EVENT_NAMES{
+    "failed_slot_cas",
+    "abandoned_slots",
+    "slow_paths",
+    "segment_allocs",
+    "lost_cas_next",
+    "ring_closes",
+    "fix_states",
+    "patience_exhausted",
+    "hp_scans",
+    "hp_reclaimed",
+};
+
+#ifdef QUEUE_EVENTS
+namespace detail {
+/** the sums of the counters of all exited threads */
+inline std::array<std::atomic<std::uint64_t>, EVENT_COUNT> totals{};
+
+struct thread_counters_t {
+  std::array<std::uint64_t, EVENT_COUNT> counts{};
+
+  ~thread_counters_t() noexcept {
+    this->flush();
+  }
+
+  void flush() noexcept {
+    for (std::size_t idx = 0; idx < EVENT_COUNT; ++idx) {
+      totals[idx].fetch_add(this->counts[idx], std::memory_order_relaxed);
+      this->counts[idx] = 0;
+    }
+  }
+};
+
+inline thread_local thread_counters_t thread_counters{};
+}
+
+inline void count(event_t event) noexcept {
+  detail::thread_counters.counts[static_cast<std::size_t>(event)] += 1;
+}
+
+#define QUEUE_EVENT(event) ::events::count(::events::event_t::event)
+#else
+#define QUEUE_EVENT(event) static_cast<void>(0)
+#endif
+
+/** adds the calling thread's counters to the totals right away instead of
+ *  once it exits, for threads that outlive a bench run, does nothing unless
+ *  `QUEUE_EVENTS` is defined */
+inline void flush_thread() noexcept {
+#ifdef QUEUE_EVENTS
+  detail::thread_counters.flush();
+#endif
+}
+
+/** appends the totals of the calling thread and all threads that have exited
+ *  (or flushed their counters) since the last call as one column
+ *  (`<name>:<count>/...`) and resets them, does nothing unless `QUEUE_EVENTS`
+ *  is defined */
+inline void print_totals(std::ostream& os) {
+#ifdef QUEUE_EVENTS
+  // includes the events of the calling (main) thread, e.g., of a prefill
+  flush_thread();
+  os << ",";
+  for (std::size_t idx = 0; idx < EVENT_COUNT; ++idx) {
+    const auto total = detail::totals[idx].exchange(0, std::memory_order_relaxed);
+    os << (idx == 0 ? "" : "/") << EVENT_NAMES[idx] << ":" << total;
+  }
+#else
+  static_cast<void>(os);
+#endif
+}
+}
+
+#endif /* LOO_QUEUE_BENCHES_QUEUE_EVENTS_HPP */
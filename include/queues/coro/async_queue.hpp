@@ -0,0 +1,140 @@
+#ifndef LOO_QUEUE_BENCHMARK_ASYNC_QUEUE_HPP
+#define LOO_QUEUE_BENCHMARK_ASYNC_QUEUE_HPP
+
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <utility>
+
+#include "looqueue/align.hpp"
+#include "queues/faa/faa_array.hpp"
+
+namespace coro {
+/**
+ * Adapter around any queue taking explicit thread ids, which allows coroutines
+ * to `co_await queue.pop(thread_id)` instead of spinning on `dequeue`.
+ *
+ * The adapter maintains a counter of available elements minus waiting
+ * coroutines (i.e., a semaphore): a pop that decrements a positive counter has
+ * claimed an element in the wrapped queue, otherwise it registers itself in a
+ * lock-free waiter queue (a `faa::queue`) and suspends.
+ * A push that increments a negative counter hands its element directly to the
+ * next waiter (bypassing the wrapped queue) and resumes the waiting coroutine
+ * inline, on the pushing thread.
+ * Hence, the promise of an awaiting coroutine must have a `thread_id` member
+ * (like `coro::task`), which the push sets to its own thread id beforehand.
+ */
+template <typename Q>
+class queue {
+  static constexpr std::size_t MAX_THREADS = 128;
+  /** ordering constants */
+  static constexpr auto relaxed = std::memory_order_relaxed;
+  static constexpr auto acq_rel = std::memory_order_acq_rel;
+
+  /** suspended (or suspending) pop operation */
+  struct waiter_t {
+    std::coroutine_handle<> handle{ };
+    /** the thread id of the awaiting coroutine's promise */
+    std::size_t*            thread_id{ nullptr };
+    typename Q::pointer     elem{ nullptr };
+  };
+
+public:
+  using inner_queue = Q;
+  using pointer     = typename Q::pointer;
+
+  class pop_awaiter;
+
+  /** constructor, forwards all arguments to the wrapped queue */
+  template <typename... Args>
+  explicit queue(Args&&... args) :
+    m_queue{ std::forward<Args>(args)... },
+    m_waiters{ MAX_THREADS }
+  {}
+
+  /** enqueues the element or hands it to a waiting coroutine, which is resumed
+   *  before this function returns */
+  void push(pointer elem, std::size_t thread_id) {
+    if (this->m_count.fetch_add(1, acq_rel) >= 0) {
+      this->m_queue.enqueue(elem, thread_id);
+      return;
+    }
+
+    // the waiter has already decremented the counter but may not yet have
+    // registered itself
+    waiter_t* waiter;
+    while ((waiter = this->m_waiters.dequeue(thread_id)) == nullptr) {}
+
+    waiter->elem = elem;
+    *waiter->thread_id = thread_id;
+    waiter->handle.resume();
+  }
+
+  /** returns an awaitable, which completes with the next element */
+  [[nodiscard]] pop_awaiter pop(std::size_t thread_id) noexcept {
+    return pop_awaiter{ *this, thread_id };
+  }
+
+  class pop_awaiter {
+  public:
+    pop_awaiter(queue& queue, std::size_t thread_id) noexcept :
+      m_queue{ queue }, m_thread_id{ thread_id } {}
+
+    /** claims an element without suspending, if one is available */
+    bool await_ready() {
+      auto count = this->m_queue.m_count.load(relaxed);
+      while (count > 0) {
+        if (this->m_queue.m_count.compare_exchange_weak(count, count - 1, acq_rel, relaxed)) {
+          this->m_waiter.elem = this->m_queue.take_claimed(this->m_thread_id);
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+    template <typename P>
+    bool await_suspend(std::coroutine_handle<P> handle) {
+      if (this->m_queue.m_count.fetch_sub(1, acq_rel) > 0) {
+        this->m_waiter.elem = this->m_queue.take_claimed(this->m_thread_id);
+        return false;
+      }
+
+      // the awaiter must not be accessed after its registration, since it may
+      // be resumed (and destroyed) concurrently
+      this->m_waiter.handle = handle;
+      this->m_waiter.thread_id = &handle.promise().thread_id;
+      this->m_queue.m_waiters.enqueue(&this->m_waiter, this->m_thread_id);
+      return true;
+    }
+
+    pointer await_resume() const noexcept {
+      return this->m_waiter.elem;
+    }
+
+  private:
+    queue&      m_queue;
+    std::size_t m_thread_id;
+    waiter_t    m_waiter{ };
+  };
+
+  queue(const queue&)            = delete;
+  queue(queue&&)                 = delete;
+  queue& operator=(const queue&) = delete;
+  queue& operator=(queue&&)      = delete;
+
+private:
+  /** dequeues a claimed element, which may not yet have been enqueued */
+  pointer take_claimed(std::size_t thread_id) {
+    pointer elem;
+    while ((elem = this->m_queue.dequeue(thread_id)) == nullptr) {}
+    return elem;
+  }
+
+  inner_queue                                         m_queue;
+  faa::queue<waiter_t>                                m_waiters;
+  alignas(CACHE_LINE_ALIGN) std::atomic<std::int64_t> m_count{ 0 };
+};
+}
+
+#endif /* LOO_QUEUE_BENCHMARK_ASYNC_QUEUE_HPP */
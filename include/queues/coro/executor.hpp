@@ -0,0 +1,189 @@
+#ifndef LOO_QUEUE_BENCHMARK_EXECUTOR_HPP
+#define LOO_QUEUE_BENCHMARK_EXECUTOR_HPP
+
+#include <atomic>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <utility>
+
+#include "looqueue/align.hpp"
+#include "queues/faa/faa_array.hpp"
+
+namespace coro {
+/**
+ * Fire-and-forget coroutine, which is started by spawning it on an executor
+ * and destroys itself once it completes.
+ */
+class task {
+public:
+  struct promise_type {
+    /** decremented once the task has completed */
+    std::atomic<std::size_t>* pending{ nullptr };
+    /** id of the executor thread (in `[0, threads)`) running the task, which
+     *  is set by whoever resumes it and may change across suspension points */
+    std::size_t               thread_id{ 0 };
+
+    task get_return_object() noexcept {
+      return task{ std::coroutine_handle<promise_type>::from_promise(*this) };
+    }
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept {
+      this->pending->fetch_sub(1, std::memory_order_release);
+      return {};
+    }
+
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }
+  };
+
+  task(task&& other) noexcept : m_handle{ std::exchange(other.m_handle, nullptr) } {}
+  ~task() noexcept {
+    if (this->m_handle) {
+      this->m_handle.destroy();
+    }
+  }
+
+  /** transfers ownership of the (not yet started) coroutine */
+  std::coroutine_handle<promise_type> release() noexcept {
+    return std::exchange(this->m_handle, nullptr);
+  }
+
+  task(const task&)            = delete;
+  task& operator=(const task&) = delete;
+  task& operator=(task&&)      = delete;
+
+private:
+  explicit task(std::coroutine_handle<promise_type> handle) noexcept : m_handle{ handle } {}
+
+  std::coroutine_handle<promise_type> m_handle;
+};
+
+/**
+ * Awaitable, which completes without suspending with a reference to the id of
+ * the executor thread running the awaiting task.
+ *
+ * The referenced id is updated whenever the task is resumed, so it must be
+ * read anew after each suspension point. Unlike a thread-local variable, whose
+ * address the compiler may cache across a suspension point, after which the
+ * task may run on a different thread, it always belongs to the task itself.
+ */
+struct thread_id_awaiter {
+  const std::size_t* thread_id{ nullptr };
+
+  bool await_ready() const noexcept { return false; }
+  bool await_suspend(std::coroutine_handle<task::promise_type> handle) noexcept {
+    this->thread_id = &handle.promise().thread_id;
+    return false;
+  }
+  const std::size_t& await_resume() const noexcept { return *this->thread_id; }
+};
+
+/** returns an awaitable for the id of the executor thread running the calling
+ *  task, i.e., `const auto& thread_id = co_await coro::this_thread_id();` */
+[[nodiscard]] inline thread_id_awaiter this_thread_id() noexcept {
+  return thread_id_awaiter{ };
+}
+
+/** executor running all tasks on the thread calling `run` */
+class single_thread_executor {
+public:
+  /** awaitable, which reschedules the calling task behind all ready tasks */
+  struct yield_awaiter {
+    single_thread_executor& executor;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<task::promise_type> handle) {
+      this->executor.m_ready.push_back(handle);
+    }
+    void await_resume() const noexcept {}
+  };
+
+  void spawn(task task) {
+    auto handle = task.release();
+    handle.promise().pending = &this->m_pending;
+    this->m_pending.fetch_add(1, std::memory_order_relaxed);
+    this->m_ready.push_back(handle);
+  }
+
+  [[nodiscard]] yield_awaiter yield() noexcept {
+    return yield_awaiter{ *this };
+  }
+
+  /** runs until all ready tasks have completed or are suspended elsewhere */
+  void run() {
+    while (!this->m_ready.empty()) {
+      const auto handle = this->m_ready.front();
+      this->m_ready.pop_front();
+      handle.promise().thread_id = 0;
+      handle.resume();
+    }
+  }
+
+  /** returns the number of spawned tasks, which have not yet completed */
+  [[nodiscard]] std::size_t pending() const noexcept {
+    return this->m_pending.load(std::memory_order_acquire);
+  }
+
+private:
+  std::deque<std::coroutine_handle<task::promise_type>> m_ready{ };
+  std::atomic<std::size_t>            m_pending{ 0 };
+};
+
+/** executor running all tasks on a pool of threads sharing one (lock-free)
+ *  queue of ready tasks */
+class thread_pool_executor {
+public:
+  /** awaitable, which reschedules the calling task behind all ready tasks */
+  struct yield_awaiter {
+    thread_pool_executor& executor;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<task::promise_type> handle) {
+      this->executor.m_ready.enqueue(handle.address(), handle.promise().thread_id);
+    }
+    void await_resume() const noexcept {}
+  };
+
+  /** constructor */
+  explicit thread_pool_executor(std::size_t threads) : m_threads{ threads } {}
+
+  /** must not be called concurrently with `run` */
+  void spawn(task task) {
+    auto handle = task.release();
+    handle.promise().pending = &this->m_pending;
+    this->m_pending.fetch_add(1, std::memory_order_relaxed);
+    this->m_ready.enqueue(handle.address(), 0);
+  }
+
+  [[nodiscard]] yield_awaiter yield() noexcept {
+    return yield_awaiter{ *this };
+  }
+
+  /** runs the loop of the pool thread with the given id (in `[0, threads)`)
+   *  on the calling thread until all tasks have completed, the loops of all
+   *  ids must run concurrently, e.g., as jobs of persistent worker threads */
+  void run(std::size_t thread) {
+    while (this->m_pending.load(std::memory_order_acquire) != 0) {
+      const auto addr = this->m_ready.dequeue(thread);
+      if (addr != nullptr) {
+        const auto handle = std::coroutine_handle<task::promise_type>::from_address(addr);
+        handle.promise().thread_id = thread;
+        handle.resume();
+      }
+    }
+  }
+
+  [[nodiscard]] std::size_t threads() const noexcept {
+    return this->m_threads;
+  }
+
+private:
+  const std::size_t                                  m_threads;
+  faa::queue<void>                                   m_ready{ };
+  alignas(CACHE_LINE_ALIGN) std::atomic<std::size_t> m_pending{ 0 };
+};
+}
+
+#endif /* LOO_QUEUE_BENCHMARK_EXECUTOR_HPP */
@@ -0,0 +1,168 @@
+#ifndef LOO_QUEUE_BENCHMARK_EVENTFD_QUEUE_HPP
+#define LOO_QUEUE_BENCHMARK_EVENTFD_QUEUE_HPP
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <span>
+#include <system_error>
+#include <utility>
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "looqueue/align.hpp"
+#include "queues/queue_ref.hpp"
+
+namespace evt {
+/**
+ * Wrapper around any queue taking explicit thread ids, which signals an
+ * `eventfd` when the queue goes from empty to non-empty, so that consumers can
+ * wait for elements in an `epoll`-based event loop instead of a futex.
+ *
+ * Consumers drain the queue (e.g., with `dequeue_batch`) and, once they find it
+ * empty, call `arm` before waiting for the eventfd to become readable.
+ * Only the first enqueue after the queue was armed performs a syscall (which
+ * also disarms it), all other enqueues only read the (rarely written) armed
+ * flag, so signals are coalesced for as long as the consumer is busy.
+ */
+template <typename Q>
+class queue {
+public:
+  using inner_queue = Q;
+  using pointer     = typename Q::pointer;
+
+  /** role restrictions of the wrapped queue apply */
+  static constexpr bool SINGLE_PRODUCER = [] {
+    if constexpr (requires { Q::SINGLE_PRODUCER; }) {
+      return Q::SINGLE_PRODUCER;
+    } else {
+      return false;
+    }
+  }();
+  static constexpr bool SINGLE_CONSUMER = [] {
+    if constexpr (requires { Q::SINGLE_CONSUMER; }) {
+      return Q::SINGLE_CONSUMER;
+    } else {
+      return false;
+    }
+  }();
+
+  /** constructor, forwards all arguments to the wrapped queue */
+  template <typename... Args>
+  explicit queue(Args&&... args) :
+    m_queue{ std::forward<Args>(args)... },
+    m_fd{ ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC) }
+  {
+    if (this->m_fd == -1) {
+      throw std::system_error(errno, std::generic_category(), "failed to create eventfd");
+    }
+  }
+
+  /** destructor */
+  ~queue() noexcept {
+    ::close(this->m_fd);
+  }
+
+  /** returns the eventfd, which becomes readable when an armed queue receives
+   *  an element */
+  [[nodiscard]] int fd() const noexcept {
+    return this->m_fd;
+  }
+
+  /** returns the number of signals (i.e., `write` syscalls) issued so far */
+  [[nodiscard]] std::uint64_t signals() const noexcept {
+    return this->m_signals.load(relaxed);
+  }
+
+  void enqueue(pointer elem, std::size_t thread_id) {
+    this->m_queue.enqueue(elem, thread_id);
+    // orders the enqueue before the load of the armed flag, pairs with the
+    // store in `arm`, so either the consumer finds the element or this thread
+    // finds the flag set
+    std::atomic_thread_fence(seq_cst);
+    if (this->m_armed.load(relaxed) && this->m_armed.exchange(false, acquire)) {
+      this->signal();
+    }
+  }
+
+  pointer dequeue(std::size_t thread_id) {
+    return this->m_queue.dequeue(thread_id);
+  }
+
+  /** dequeues up to `elems.size()` elements, returns the number of elements */
+  std::size_t dequeue_batch(std::span<pointer> elems, std::size_t thread_id) {
+    std::size_t count = 0;
+    while (count < elems.size()) {
+      const auto elem = this->m_queue.dequeue(thread_id);
+      if (elem == nullptr) {
+        break;
+      }
+
+      elems[count++] = elem;
+    }
+
+    return count;
+  }
+
+  /**
+   * Arms the queue after it was found empty and checks once more for an
+   * element enqueued in the meantime.
+   *
+   * If `nullptr` is returned, the caller may wait for the eventfd to become
+   * readable, otherwise it has to process the returned element and continue
+   * draining the queue.
+   */
+  pointer arm(std::size_t thread_id) {
+    this->m_armed.store(true, seq_cst);
+    // orders the store of the armed flag before the loads of the re-check,
+    // pairs with the fence in `enqueue`: a seq_cst store alone does not keep
+    // the dequeue's (possibly weaker) loads from being reordered before it
+    std::atomic_thread_fence(seq_cst);
+    const auto elem = this->m_queue.dequeue(thread_id);
+    if (elem != nullptr) {
+      // a producer may have already disarmed the queue and signalled, which
+      // only results in a spurious wake-up
+      this->m_armed.store(false, relaxed);
+    }
+
+    return elem;
+  }
+
+  /** resets the eventfd after it became readable */
+  void clear() noexcept {
+    std::uint64_t count;
+    (void) ::read(this->m_fd, &count, sizeof(count));
+  }
+
+  queue(const queue&)            = delete;
+  queue(queue&&)                 = delete;
+  queue& operator=(const queue&) = delete;
+  queue& operator=(queue&&)      = delete;
+
+private:
+  /** ordering constants */
+  static constexpr auto relaxed = std::memory_order_relaxed;
+  static constexpr auto acquire = std::memory_order_acquire;
+  static constexpr auto seq_cst = std::memory_order_seq_cst;
+
+  void signal() {
+    const std::uint64_t one = 1;
+    if (::write(this->m_fd, &one, sizeof(one)) == -1 && errno != EAGAIN) {
+      throw std::system_error(errno, std::generic_category(), "failed to signal eventfd");
+    }
+
+    this->m_signals.fetch_add(1, relaxed);
+  }
+
+  inner_queue                                          m_queue;
+  const int                                            m_fd;
+  alignas(CACHE_LINE_ALIGN) std::atomic<bool>          m_armed{ false };
+  alignas(CACHE_LINE_ALIGN) std::atomic<std::uint64_t> m_signals{ 0 };
+};
+
+template <typename Q>
+using queue_ref = queue_ref<queue<Q>>;
+}
+
+#endif /* LOO_QUEUE_BENCHMARK_EVENTFD_QUEUE_HPP */
@@ -6,6 +6,7 @@
 #include <cstdint>
 #include <atomic>
 #include <array>
+#include <span>
 
 #include "looqueue/align.hpp"
 
@@ -18,6 +19,8 @@ struct queue<T, V>::node_t {
   slot_array_t               slots{ };
   std::atomic<std::uint32_t> enq_idx{ 0 };
   std::atomic<node_t*>       next{ nullptr };
+  /** position in the list of nodes, set before the node is linked */
+  std::uint64_t              seq{ 0 };
 
   node_t() {
     this->init_slots();
@@ -28,6 +31,16 @@ struct queue<T, V>::node_t {
     this->slots[0].store(first, std::memory_order_relaxed);
   }
 
+  /** pre-filled node, the remaining slots (if any) can still be enqueued to */
+  explicit node_t(std::span<const queue::pointer> elems) :
+    enq_idx{ static_cast<std::uint32_t>(elems.size()) }
+  {
+    this->init_slots();
+    for (std::size_t idx = 0; idx < elems.size(); ++idx) {
+      this->slots[idx].store(elems[idx], std::memory_order_relaxed);
+    }
+  }
+
   bool cas_slot_at(
       std::size_t idx,
       queue::pointer expected,
@@ -4,6 +4,11 @@
 #include "faa_array_fwd.hpp"
 #include "queues/faa/detail/node.hpp"
 
+#include <algorithm>
+#include <stdexcept>
+
+#include "queue_events.hpp"
+
 namespace faa {
 template <typename T, detail::queue_variant_t V>
 queue<T, V>::queue(std::size_t max_threads) : m_hazard_ptrs{ max_threads, 1 } {
@@ -45,9 +50,11 @@ void queue<T, V>::enqueue(queue::pointer elem, std::size_t thread_id) {
         break;
       }
 
+      QUEUE_EVENT(FAILED_SLOT_CAS);
       continue;
     } else {
       // ** slow path ** append new tail node or update the tail pointer
+      QUEUE_EVENT(SLOW_PATH);
       if (tail != this->m_tail.load(relaxed)) {
         continue;
       }
@@ -55,11 +62,14 @@ void queue<T, V>::enqueue(queue::pointer elem, std::size_t thread_id) {
       const auto next = tail->next.load(acquire);
       if (next == nullptr) {
         auto node = new node_t(elem);
+        QUEUE_EVENT(SEGMENT_ALLOC);
+        node->seq = tail->seq + 1;
         if (tail->cas_next(nullptr, node, release)) {
           this->cas_tail(tail, node, release);
           break;
         }
 
+        QUEUE_EVENT(LOST_CAS_NEXT);
         delete node;
       } else {
         this->cas_tail(tail, next, release);
@@ -70,6 +80,68 @@ void queue<T, V>::enqueue(queue::pointer elem, std::size_t thread_id) {
   this->m_hazard_ptrs.clear_one(thread_id, HP_ENQ_TAIL);
 }
 
+template <typename T, detail::queue_variant_t V>
+void queue<T, V>::enqueue_segment(std::span<const pointer> elems, std::size_t thread_id) {
+  if (elems.empty()) {
+    return;
+  }
+
+  for (const auto elem : elems) {
+    if (elem == nullptr) [[unlikely]] {
+      throw std::invalid_argument("enqueue element must not be null");
+    }
+  }
+
+  // build the (private) chain of pre-filled nodes
+  node_t* first = nullptr;
+  node_t* last  = nullptr;
+  for (std::size_t offset = 0; offset < elems.size(); offset += NODE_SIZE) {
+    const auto count = std::min(NODE_SIZE, elems.size() - offset);
+    auto node = new node_t(elems.subspan(offset, count));
+    QUEUE_EVENT(SEGMENT_ALLOC);
+    if (last == nullptr) {
+      first = node;
+    } else {
+      last->next.store(node, relaxed);
+    }
+
+    last = node;
+  }
+
+  while (true) {
+    const auto tail = this->m_hazard_ptrs.protect_ptr(
+        this->m_tail.load(relaxed),
+        thread_id, HP_ENQ_TAIL
+    );
+
+    if (tail != this->m_tail.load(acquire)) [[unlikely]] {
+      continue;
+    }
+
+    const auto next = tail->next.load(acquire);
+    if (next != nullptr) {
+      this->cas_tail(tail, next, release);
+      continue;
+    }
+
+    auto seq = tail->seq;
+    for (auto node = first; node != nullptr; node = node->next.load(relaxed)) {
+      node->seq = ++seq;
+    }
+
+    // free slots left in the current tail can only be filled by enqueuers that
+    // have already loaded it, all others are eventually abandoned by dequeuers;
+    // if the tail CAS fails, the full intermediate nodes cause other enqueuers
+    // to advance the tail pointer along the spliced chain
+    if (tail->cas_next(nullptr, first, release)) {
+      this->cas_tail(tail, last, release);
+      break;
+    }
+  }
+
+  this->m_hazard_ptrs.clear_one(thread_id, HP_ENQ_TAIL);
+}
+
 template <typename T, detail::queue_variant_t V>
 typename queue<T, V>::pointer queue<T, V>::dequeue(std::size_t thread_id) {
   pointer res = nullptr;
@@ -99,9 +171,11 @@ typename queue<T, V>::pointer queue<T, V>::dequeue(std::size_t thread_id) {
       }
 
       // abandon the slot and attempt to dequeue from another slot
+      QUEUE_EVENT(ABANDONED_SLOT);
       continue;
     } else {
       // ** slow path ** advance the head pointer to the next node
+      QUEUE_EVENT(SLOW_PATH);
       const auto next = head->next.load(acquire);
       if (next == nullptr) {
         break;
@@ -119,6 +193,25 @@ typename queue<T, V>::pointer queue<T, V>::dequeue(std::size_t thread_id) {
   return res;
 }
 
+template <typename T, detail::queue_variant_t V>
+std::size_t queue<T, V>::approx_size(std::size_t thread_id) {
+  // the tail and head are read one after the other (using the same hazard
+  // pointer), so the result is no atomic snapshot; indices may also exceed the
+  // node size due to failed reservations
+  const auto tail = this->m_hazard_ptrs.protect(this->m_tail, thread_id, HP_ENQ_TAIL);
+  const auto enqueued =
+      tail->seq * NODE_SIZE
+      + std::min<std::size_t>(tail->enq_idx.load(relaxed), NODE_SIZE);
+
+  const auto head = this->m_hazard_ptrs.protect(this->m_head, thread_id, HP_DEQ_HEAD);
+  const auto dequeued =
+      head->seq * NODE_SIZE
+      + std::min<std::size_t>(head->deq_idx.load(relaxed), NODE_SIZE);
+
+  this->m_hazard_ptrs.clear_one(thread_id, HP_DEQ_HEAD);
+  return enqueued > dequeued ? enqueued - dequeued : 0;
+}
+
 template <typename T, detail::queue_variant_t V>
 bool queue<T, V>::is_empty(queue::node_t* head) {
   if constexpr (V == detail::queue_variant_t::ORIGINAL) {
@@ -2,6 +2,7 @@
 #define LOO_QUEUE_BENCHMARK_FAA_ARRAY_FWD_HPP
 
 #include <atomic>
+#include <span>
 
 #include "hazard_pointers/hazard_pointers.hpp"
 #include "looqueue/align.hpp"
@@ -43,11 +44,20 @@ class queue {
 public:
   using pointer = T*;
 
+  /** number of elements per pre-filled segment */
+  static constexpr std::size_t SEGMENT_SIZE = NODE_SIZE;
+
   /** constructor */
   explicit queue(std::size_t max_threads = MAX_THREADS);
   ~queue() noexcept;
   void enqueue(pointer elem, std::size_t thread_id);
+  /** appends all elements at once as a chain of privately pre-filled nodes,
+   *  without reserving any slots through the (contended) enqueue indices */
+  void enqueue_segment(std::span<const pointer> elems, std::size_t thread_id);
   pointer dequeue(std::size_t thread_id);
+  /** returns the approximate number of enqueued elements, based only on the
+   *  indices and sequence numbers of the current head and tail nodes */
+  std::size_t approx_size(std::size_t thread_id);
 
   queue(const queue&)             = delete;
   queue(queue&&)                  = delete;
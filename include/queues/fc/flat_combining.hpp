@@ -0,0 +1,84 @@
+#ifndef LOO_QUEUE_BENCHMARK_FLAT_COMBINING_HPP
+#define LOO_QUEUE_BENCHMARK_FLAT_COMBINING_HPP
+
+#include "flat_combining_fwd.hpp"
+
+#include <stdexcept>
+
+namespace fc {
+template <typename T>
+queue<T>::queue(std::size_t max_threads) : m_records(max_threads) {}
+
+template <typename T>
+void queue<T>::enqueue(queue::pointer elem, std::size_t thread_id) {
+  if (elem == nullptr) [[unlikely]] {
+    throw std::invalid_argument("enqueue element must not be null");
+  }
+
+  auto& record = this->m_records[thread_id];
+  record.elem = elem;
+  this->publish_and_wait(record, OP_ENQUEUE, thread_id);
+}
+
+template <typename T>
+typename queue<T>::pointer queue<T>::dequeue(std::size_t thread_id) {
+  auto& record = this->m_records[thread_id];
+  this->publish_and_wait(record, OP_DEQUEUE, thread_id);
+  return record.elem;
+}
+
+template <typename T>
+void queue<T>::publish_and_wait(
+    queue::record_t& record,
+    std::uint32_t op,
+    std::size_t thread_id
+) {
+  // the combiner only scans the records up to the highest id that has been
+  // used so far, which is raised (once) when a thread first publishes
+  auto active = this->m_active_records.load(relaxed);
+  while (thread_id >= active) [[unlikely]] {
+    if (this->m_active_records.compare_exchange_weak(active, thread_id + 1, relaxed, relaxed)) {
+      break;
+    }
+  }
+
+  record.op.store(op, release);
+
+  while (true) {
+    if (record.op.load(acquire) == OP_NONE) {
+      return;
+    }
+
+    // test-and-test-and-set, only the thread acquiring the lock combines
+    if (!this->m_lock.load(relaxed) && !this->m_lock.exchange(true, acquire)) {
+      this->combine();
+      this->m_lock.store(false, release);
+      // the combiner always applies its own operation in its first pass
+      return;
+    }
+  }
+}
+
+template <typename T>
+void queue<T>::combine() {
+  for (std::size_t pass = 0; pass < COMBINE_PASSES; ++pass) {
+    const auto active = this->m_active_records.load(acquire);
+    for (std::size_t idx = 0; idx < active; ++idx) {
+      auto& record = this->m_records[idx];
+      switch (record.op.load(acquire)) {
+        case OP_ENQUEUE:
+          this->m_ring.push_back(record.elem);
+          break;
+        case OP_DEQUEUE:
+          record.elem = this->m_ring.pop_front();
+          break;
+        default: continue;
+      }
+
+      record.op.store(OP_NONE, release);
+    }
+  }
+}
+}
+
+#endif /* LOO_QUEUE_BENCHMARK_FLAT_COMBINING_HPP */
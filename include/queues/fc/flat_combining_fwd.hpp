@@ -0,0 +1,65 @@
+#ifndef LOO_QUEUE_BENCHMARK_FLAT_COMBINING_FWD_HPP
+#define LOO_QUEUE_BENCHMARK_FLAT_COMBINING_FWD_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "looqueue/align.hpp"
+#include "queues/queue_ref.hpp"
+#include "queues/seq/ring_buffer.hpp"
+
+namespace fc {
+/** Implementation of a flat combining queue by Hendler et al. */
+template <typename T>
+class queue {
+public:
+  using pointer = T*;
+
+  /** constructor */
+  explicit queue(std::size_t max_threads = MAX_THREADS);
+  void enqueue(pointer elem, std::size_t thread_id);
+  pointer dequeue(std::size_t thread_id);
+
+  queue(const queue&)            = delete;
+  queue(queue&&)                 = delete;
+  queue& operator=(const queue&) = delete;
+  queue& operator=(queue&&)      = delete;
+
+private:
+  static constexpr std::size_t MAX_THREADS = 128;
+  /** number of passes over the publication records per combining round */
+  static constexpr std::size_t COMBINE_PASSES = 2;
+  /** operation codes for publication records */
+  static constexpr std::uint32_t OP_NONE    = 0;
+  static constexpr std::uint32_t OP_ENQUEUE = 1;
+  static constexpr std::uint32_t OP_DEQUEUE = 2;
+  /** ordering constants */
+  static constexpr auto relaxed = std::memory_order_relaxed;
+  static constexpr auto acquire = std::memory_order_acquire;
+  static constexpr auto release = std::memory_order_release;
+
+  /** each thread publishes its pending operation in its own record, the
+   *  argument (or result) is only ever accessed by either the owning thread or
+   *  the current combiner */
+  struct alignas(CACHE_LINE_ALIGN) record_t {
+    std::atomic<std::uint32_t> op{ OP_NONE };
+    pointer elem{ nullptr };
+  };
+
+  /** publishes the operation and waits until it has been applied */
+  void publish_and_wait(record_t& record, std::uint32_t op, std::size_t thread_id);
+  /** applies all published operations to the sequential ring */
+  void combine();
+
+  alignas(CACHE_LINE_ALIGN) std::atomic_bool         m_lock{ false };
+  alignas(CACHE_LINE_ALIGN) std::atomic<std::size_t> m_active_records{ 0 };
+  alignas(CACHE_LINE_ALIGN) seq::ring_buffer<T>      m_ring{ };
+  alignas(CACHE_LINE_ALIGN) std::vector<record_t>    m_records;
+};
+
+template <typename T>
+using queue_ref = queue_ref<queue<T>>;
+}
+
+#endif /* LOO_QUEUE_BENCHMARK_FLAT_COMBINING_FWD_HPP */
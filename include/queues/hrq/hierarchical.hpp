@@ -0,0 +1,174 @@
+#ifndef LOO_QUEUE_BENCHMARK_HIERARCHICAL_HPP
+#define LOO_QUEUE_BENCHMARK_HIERARCHICAL_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "looqueue/align.hpp"
+#include "queues/faa/faa_array.hpp"
+#include "queues/queue_ref.hpp"
+#include "topology.hpp"
+
+namespace hrq {
+/**
+ * Relaxed (non-linearizable) NUMA-hierarchical MPMC queue, in which each NUMA
+ * node (cohort) collects elements in a local `faa::queue` and hands them off
+ * to one global `faa::queue` in batches.
+ *
+ * Threads only enqueue into the queue of their own node, so the contended
+ * enqueue indices are never shared across the interconnect. Once a node has
+ * collected `BATCH_SIZE` elements, the enqueuer that wins the node's flush
+ * flag moves a batch of them to the global queue with a single
+ * `enqueue_segment`, i.e., with one CAS on the global tail per batch instead
+ * of one fetch-and-add per element.
+ * Dequeuers only dequeue from the global queue. When they find it empty, they
+ * hand off the (incomplete) batches of all nodes early, starting with their
+ * own, element-wise, so no element is held back indefinitely. A dequeue may
+ * still report the queue as empty, while another thread is handing off a
+ * batch.
+ *
+ * Since each node hands off its batches in order (under its flush flag), the
+ * elements enqueued by the same thread are dequeued in FIFO order, but those
+ * of different nodes may overtake each other by up to one batch.
+ *
+ * Threads are mapped to nodes by the CPU their id is pinned to (cf.
+ * `topology::cpu_of_thread`).
+ */
+template <typename T>
+class queue {
+public:
+  using pointer      = T*;
+  using global_queue = faa::queue<T>;
+  using node_queue   = faa::queue<T>;
+
+  /** the number of elements handed off at once, i.e., one full segment */
+  static constexpr std::size_t BATCH_SIZE = global_queue::SEGMENT_SIZE;
+
+  /** constructor, reads the NUMA topology from sysfs */
+  explicit queue(std::size_t max_threads = MAX_THREADS) :
+    queue(topology::thread_numa_nodes(max_threads), max_threads)
+  {}
+
+  /** constructor with an explicit NUMA node for each thread id (repeated for
+   *  thread ids beyond their number) */
+  queue(const std::vector<std::size_t>& thread_nodes, std::size_t max_threads) :
+    m_global{ max_threads },
+    m_thread_nodes(max_threads, 0)
+  {
+    if (thread_nodes.empty()) {
+      throw std::invalid_argument("hierarchical queue requires at least one thread");
+    }
+
+    for (std::size_t thread = 0; thread < max_threads; ++thread) {
+      this->m_thread_nodes[thread] = thread_nodes[thread % thread_nodes.size()];
+    }
+
+    const auto nodes = *std::max_element(thread_nodes.begin(), thread_nodes.end()) + 1;
+    this->m_nodes.reserve(nodes);
+    for (std::size_t node = 0; node < nodes; ++node) {
+      this->m_nodes.push_back(std::make_unique<node_t>(max_threads));
+    }
+  }
+
+  void enqueue(pointer elem, std::size_t thread_id) {
+    auto& node = *this->m_nodes[this->m_thread_nodes[thread_id]];
+    node.queue.enqueue(elem, thread_id);
+    if (node.pending.fetch_add(1, std::memory_order_relaxed) + 1 >= static_cast<std::int64_t>(BATCH_SIZE)) {
+      this->hand_off(node, thread_id);
+    }
+  }
+
+  pointer dequeue(std::size_t thread_id) {
+    if (const auto res = this->m_global.dequeue(thread_id); res != nullptr) {
+      return res;
+    }
+
+    const auto nodes = this->m_nodes.size();
+    const auto local = this->m_thread_nodes[thread_id];
+    for (std::size_t i = 0; i < nodes; ++i) {
+      if (this->hand_off(*this->m_nodes[(local + i) % nodes], thread_id) != 0) {
+        if (const auto res = this->m_global.dequeue(thread_id); res != nullptr) {
+          return res;
+        }
+      }
+    }
+
+    return nullptr;
+  }
+
+  /** returns the number of NUMA nodes (and hence node queues) */
+  [[nodiscard]] std::size_t nodes() const noexcept {
+    return this->m_nodes.size();
+  }
+
+  queue(const queue&)            = delete;
+  queue(queue&&)                 = delete;
+  queue& operator=(const queue&) = delete;
+  queue& operator=(queue&&)      = delete;
+
+private:
+  static constexpr std::size_t MAX_THREADS = 128;
+
+  struct node_t {
+    explicit node_t(std::size_t max_threads) : queue{ max_threads } {}
+
+    node_queue                                          queue;
+    /** the number of elements enqueued but not yet handed off, which may
+     *  become negative while an element is handed off before it is counted */
+    alignas(CACHE_LINE_ALIGN) std::atomic<std::int64_t> pending{ 0 };
+    alignas(CACHE_LINE_ALIGN) std::atomic<bool>         flushing{ false };
+    /** only accessed by the thread holding the flush flag */
+    std::array<pointer, BATCH_SIZE>                     batch{ };
+  };
+
+  /** moves up to one batch from the node's queue to the global queue, unless
+   *  another thread is already doing so, returns the number of elements */
+  std::size_t hand_off(node_t& node, std::size_t thread_id) {
+    if (
+        node.flushing.load(std::memory_order_relaxed)
+        || node.flushing.exchange(true, std::memory_order_acquire)
+    ) {
+      return 0;
+    }
+
+    std::size_t count = 0;
+    while (count < BATCH_SIZE) {
+      const auto elem = node.queue.dequeue(thread_id);
+      if (elem == nullptr) {
+        break;
+      }
+
+      node.batch[count++] = elem;
+    }
+
+    // only full batches are spliced, since the free slots of a partially
+    // filled segment would be abandoned by the next splice
+    if (count == BATCH_SIZE) {
+      this->m_global.enqueue_segment(node.batch, thread_id);
+    } else {
+      for (std::size_t idx = 0; idx < count; ++idx) {
+        this->m_global.enqueue(node.batch[idx], thread_id);
+      }
+    }
+
+    node.pending.fetch_sub(static_cast<std::int64_t>(count), std::memory_order_relaxed);
+    node.flushing.store(false, std::memory_order_release);
+    return count;
+  }
+
+  alignas(CACHE_LINE_ALIGN) global_queue   m_global;
+  std::vector<std::unique_ptr<node_t>>     m_nodes{ };
+  /** read-only after construction */
+  std::vector<std::size_t>                 m_thread_nodes;
+};
+
+template <typename T>
+using queue_ref = queue_ref<queue<T>>;
+}
+
+#endif /* LOO_QUEUE_BENCHMARK_HIERARCHICAL_HPP */
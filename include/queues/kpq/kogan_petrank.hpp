@@ -0,0 +1,410 @@
+#ifndef LOO_QUEUE_BENCHMARK_KOGAN_PETRANK_HPP
+#define LOO_QUEUE_BENCHMARK_KOGAN_PETRANK_HPP
+
+#include "kogan_petrank_fwd.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace kpq {
+/********** operation descriptors *********************************************/
+
+template <typename T>
+std::uint64_t queue<T>::op_desc_t::compose() const noexcept {
+  return
+      (this->phase << 2)
+      | (static_cast<std::uint64_t>(this->pending) << 1)
+      | static_cast<std::uint64_t>(this->enqueue);
+}
+
+template <typename T>
+typename queue<T>::op_desc_t queue<T>::op_desc_t::decompose(
+    std::uint64_t state,
+    queue::node_t* node
+) noexcept {
+  return op_desc_t{ state >> 2, (state & 0b10) != 0, (state & 0b01) != 0, node };
+}
+
+template <typename T>
+typename queue<T>::op_desc_t queue<T>::state_cell_t::load() const noexcept {
+  const auto state = this->state.load(acquire);
+  const auto node  = this->node.load(acquire);
+  return op_desc_t::decompose(state, node);
+}
+
+template <typename T>
+bool queue<T>::state_cell_t::compare_exchange(
+    const op_desc_t& expected,
+    const op_desc_t& desired
+) noexcept {
+  auto expected_state = expected.compose();
+  auto expected_node  = expected.node;
+  std::uint8_t res;
+  asm volatile(
+    "lock cmpxchg16b %0"
+    : "+m"(*this), "=@ccz"(res), "+a"(expected_state), "+d"(expected_node)
+    : "b"(desired.compose()), "c"(desired.node)
+    : "memory"
+  );
+  return res != 0;
+}
+
+template <typename T>
+void queue<T>::state_cell_t::store(const op_desc_t& desired) noexcept {
+  while (!this->compare_exchange(this->load(), desired)) {}
+}
+
+/********** queue *************************************************************/
+
+template <typename T>
+queue<T>::queue(std::size_t max_threads) :
+  m_states(max_threads),
+  m_help_records(max_threads),
+  m_hazard_ptrs{ max_threads, HP_COUNT, HP_SCAN_THRESHOLD }
+{
+  // the initial sentinel has no element, so only its claiming dequeuer holds
+  // a reference to it
+  const auto sentinel = new node_t{ nullptr, 0, 1 };
+  this->m_head.store(sentinel, relaxed);
+  this->m_tail.store(sentinel, relaxed);
+}
+
+template <typename T>
+queue<T>::~queue() noexcept {
+  auto curr = this->m_head.load(relaxed);
+  while (curr != nullptr) {
+    const auto next = curr->next.load(relaxed);
+    delete curr;
+    curr = next;
+  }
+}
+
+template <typename T>
+void queue<T>::enqueue(queue::pointer elem, std::size_t thread_id) {
+  if (elem == nullptr) [[unlikely]] {
+    throw std::invalid_argument("enqueue element must not be null");
+  }
+
+  this->register_thread(thread_id);
+  this->help_if_needed(thread_id);
+
+  const auto node = new node_t{ elem, NO_ENQUEUER, 2 };
+  if (this->try_fast_enqueue(node, thread_id)) {
+    this->m_hazard_ptrs.clear(thread_id);
+    return;
+  }
+
+  // the node has not been published, so it can be handed to the slow path
+  node->enq_tid = thread_id;
+  const auto phase = this->max_phase() + 1;
+  this->m_states[thread_id].store({ phase, true, true, node });
+
+  this->help(phase, thread_id);
+  this->help_finish_enq(thread_id);
+
+  this->m_hazard_ptrs.clear(thread_id);
+}
+
+template <typename T>
+typename queue<T>::pointer queue<T>::dequeue(std::size_t thread_id) {
+  this->register_thread(thread_id);
+  this->help_if_needed(thread_id);
+
+  pointer res;
+  if (this->try_fast_dequeue(res, thread_id)) {
+    return res;
+  }
+
+  const auto phase = this->max_phase() + 1;
+  this->m_states[thread_id].store({ phase, true, false, nullptr });
+
+  this->help(phase, thread_id);
+  this->help_finish_deq(thread_id);
+
+  this->m_hazard_ptrs.clear(thread_id);
+
+  // the completed descriptor holds the sentinel node claimed by this thread or
+  // nullptr, if the queue was found to be empty
+  const auto node = this->m_states[thread_id].node.load(acquire);
+  if (node == nullptr) {
+    return nullptr;
+  }
+
+  // the claimed node and its successor can not have been reclaimed, since
+  // this thread still holds one reference to each
+  const auto next = node->next.load(acquire);
+  res = next->elem;
+
+  this->release_node(next, thread_id);
+  this->release_node(node, thread_id);
+
+  return res;
+}
+
+template <typename T>
+void queue<T>::help_if_needed(std::size_t thread_id) {
+  auto& record = this->m_help_records[thread_id];
+  if (--record.countdown != 0) {
+    return;
+  }
+
+  // the checked operation is helped, if it has not completed since the last
+  // check, i.e., throughout the last `HELPING_DELAY` operations of this thread
+  const auto desc = op_desc_t::decompose(this->m_states[record.tid].state.load(acquire), nullptr);
+  if (desc.pending && desc.phase == record.phase) {
+    if (desc.enqueue) {
+      this->help_enq(record.tid, desc.phase, thread_id);
+    } else {
+      this->help_deq(record.tid, desc.phase, thread_id);
+    }
+  }
+
+  record.tid = (record.tid + 1) % this->m_active_threads.load(acquire);
+  record.phase = this->m_states[record.tid].state.load(acquire) >> 2;
+  record.countdown = HELPING_DELAY;
+}
+
+template <typename T>
+bool queue<T>::try_fast_enqueue(queue::node_t* node, std::size_t thread_id) {
+  for (std::size_t tries = 0; tries < MAX_FAST_PATH_TRIES; ++tries) {
+    const auto last = this->m_hazard_ptrs.protect(this->m_tail, thread_id, HP_TAIL);
+    const auto next = last->next.load(acquire);
+    if (last != this->m_tail.load(acquire)) {
+      continue;
+    }
+
+    if (next != nullptr) {
+      // some other enqueue is in progress, help it complete first
+      this->help_finish_enq(thread_id);
+      continue;
+    }
+
+    node_t* expected = nullptr;
+    if (last->next.compare_exchange_strong(expected, node, release, relaxed)) {
+      auto expected_tail = last;
+      this->m_tail.compare_exchange_strong(expected_tail, node, release, relaxed);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+template <typename T>
+bool queue<T>::try_fast_dequeue(queue::pointer& res, std::size_t thread_id) {
+  for (std::size_t tries = 0; tries < MAX_FAST_PATH_TRIES; ++tries) {
+    const auto first = this->m_hazard_ptrs.protect(this->m_head, thread_id, HP_HEAD);
+    const auto last  = this->m_tail.load(acquire);
+    const auto next  = first->next.load(acquire);
+    if (first != this->m_head.load(acquire)) {
+      continue;
+    }
+
+    if (first == last) {
+      if (next == nullptr) {
+        this->m_hazard_ptrs.clear(thread_id);
+        res = nullptr;
+        return true;
+      }
+
+      // some enqueue is in progress, help it complete first
+      this->help_finish_enq(thread_id);
+      continue;
+    }
+
+    auto expected = NO_THREAD;
+    const auto claimed = first->deq_tid.compare_exchange_strong(expected, FAST_PATH_THREAD);
+    // either way, the head must be advanced past the claimed node
+    this->help_finish_deq(thread_id);
+    if (!claimed) {
+      continue;
+    }
+
+    this->m_hazard_ptrs.clear(thread_id);
+
+    // as on the slow path, this thread holds one reference to the claimed
+    // node and one to its successor
+    res = next->elem;
+    this->release_node(next, thread_id);
+    this->release_node(first, thread_id);
+
+    return true;
+  }
+
+  return false;
+}
+
+template <typename T>
+void queue<T>::register_thread(std::size_t thread_id) {
+  // descriptors are only scanned up to the highest id that has been used so
+  // far, which is raised (once) when a thread first performs an operation
+  auto active = this->m_active_threads.load(relaxed);
+  while (thread_id >= active) [[unlikely]] {
+    if (this->m_active_threads.compare_exchange_weak(active, thread_id + 1)) {
+      break;
+    }
+  }
+}
+
+template <typename T>
+std::uint64_t queue<T>::max_phase() const {
+  std::uint64_t res = 0;
+  const auto active = this->m_active_threads.load(acquire);
+  for (std::size_t tid = 0; tid < active; ++tid) {
+    res = std::max(res, this->m_states[tid].state.load(acquire) >> 2);
+  }
+
+  return res;
+}
+
+template <typename T>
+bool queue<T>::is_still_pending(std::size_t tid, std::uint64_t phase) const {
+  const auto desc = op_desc_t::decompose(this->m_states[tid].state.load(acquire), nullptr);
+  return desc.pending && desc.phase <= phase;
+}
+
+template <typename T>
+void queue<T>::help(std::uint64_t phase, std::size_t thread_id) {
+  const auto active = this->m_active_threads.load(acquire);
+  for (std::size_t tid = 0; tid < active; ++tid) {
+    const auto desc = op_desc_t::decompose(this->m_states[tid].state.load(acquire), nullptr);
+    if (desc.pending && desc.phase <= phase) {
+      if (desc.enqueue) {
+        this->help_enq(tid, phase, thread_id);
+      } else {
+        this->help_deq(tid, phase, thread_id);
+      }
+    }
+  }
+}
+
+template <typename T>
+void queue<T>::help_enq(std::size_t tid, std::uint64_t phase, std::size_t thread_id) {
+  while (this->is_still_pending(tid, phase)) {
+    const auto last = this->m_hazard_ptrs.protect(this->m_tail, thread_id, HP_TAIL);
+    const auto next = last->next.load(acquire);
+    if (last != this->m_tail.load(acquire)) {
+      continue;
+    }
+
+    if (next != nullptr) {
+      // some other enqueue is in progress, help it complete first
+      this->help_finish_enq(thread_id);
+      continue;
+    }
+
+    if (this->is_still_pending(tid, phase)) {
+      node_t* expected = nullptr;
+      const auto node = this->m_states[tid].node.load(acquire);
+      if (last->next.compare_exchange_strong(expected, node, release, relaxed)) {
+        this->help_finish_enq(thread_id);
+        return;
+      }
+    }
+  }
+}
+
+template <typename T>
+void queue<T>::help_finish_enq(std::size_t thread_id) {
+  const auto last = this->m_hazard_ptrs.protect(this->m_tail, thread_id, HP_TAIL);
+  const auto next = last->next.load(acquire);
+  if (next == nullptr) {
+    return;
+  }
+
+  // as long as the tail has not moved past `last`, its successor can not have
+  // been dequeued and hence not reclaimed either
+  this->m_hazard_ptrs.protect_ptr(next, thread_id, HP_NEXT);
+  if (last != this->m_tail.load(acquire)) {
+    return;
+  }
+
+  // nodes appended on the fast path have no descriptor to complete
+  const auto tid = next->enq_tid;
+  if (tid != NO_ENQUEUER) {
+    const auto curr = this->m_states[tid].load();
+    if (last == this->m_tail.load(acquire) && curr.node == next) {
+      this->m_states[tid].compare_exchange(curr, { curr.phase, false, true, next });
+    }
+  }
+
+  auto expected = last;
+  this->m_tail.compare_exchange_strong(expected, next, release, relaxed);
+}
+
+template <typename T>
+void queue<T>::help_deq(std::size_t tid, std::uint64_t phase, std::size_t thread_id) {
+  while (this->is_still_pending(tid, phase)) {
+    const auto first = this->m_hazard_ptrs.protect(this->m_head, thread_id, HP_HEAD);
+    const auto last  = this->m_tail.load(acquire);
+    const auto next  = first->next.load(acquire);
+    if (first != this->m_head.load(acquire)) {
+      continue;
+    }
+
+    if (first == last) {
+      if (next == nullptr) {
+        // the queue is empty, complete the dequeue without a node
+        const auto curr = this->m_states[tid].load();
+        if (last == this->m_tail.load(acquire) && this->is_still_pending(tid, phase)) {
+          this->m_states[tid].compare_exchange(curr, { curr.phase, false, false, nullptr });
+        }
+      } else {
+        // some enqueue is in progress, help it complete first
+        this->help_finish_enq(thread_id);
+      }
+
+      continue;
+    }
+
+    const auto curr = this->m_states[tid].load();
+    if (!this->is_still_pending(tid, phase)) {
+      break;
+    }
+
+    // announce the current sentinel as the node to be claimed
+    if (first == this->m_head.load(acquire) && curr.node != first) {
+      if (!this->m_states[tid].compare_exchange(curr, { curr.phase, true, false, first })) {
+        continue;
+      }
+    }
+
+    auto expected = NO_THREAD;
+    first->deq_tid.compare_exchange_strong(expected, static_cast<std::int64_t>(tid));
+    this->help_finish_deq(thread_id);
+  }
+}
+
+template <typename T>
+void queue<T>::help_finish_deq(std::size_t thread_id) {
+  const auto first = this->m_hazard_ptrs.protect(this->m_head, thread_id, HP_HEAD);
+  const auto next  = first->next.load(acquire);
+  const auto tid   = first->deq_tid.load(acquire);
+  if (tid == NO_THREAD) {
+    return;
+  }
+
+  // the descriptor must be read before the head is checked, otherwise it may
+  // already belong to the claiming thread's next operation; nodes claimed on
+  // the fast path have no descriptor to complete
+  const auto fast_path = tid == FAST_PATH_THREAD;
+  const auto curr = fast_path ? op_desc_t{} : this->m_states[tid].load();
+  if (first == this->m_head.load(acquire) && next != nullptr) {
+    if (!fast_path) {
+      this->m_states[tid].compare_exchange(curr, { curr.phase, false, false, curr.node });
+    }
+
+    auto expected = first;
+    this->m_head.compare_exchange_strong(expected, next, release, relaxed);
+  }
+}
+
+template <typename T>
+void queue<T>::release_node(queue::node_t* node, std::size_t thread_id) {
+  if (node->refs.fetch_sub(1, acq_rel) == 1) {
+    this->m_hazard_ptrs.retire(node, thread_id);
+  }
+}
+}
+
+#endif /* LOO_QUEUE_BENCHMARK_KOGAN_PETRANK_HPP */
@@ -0,0 +1,155 @@
+#ifndef LOO_QUEUE_BENCHMARK_KOGAN_PETRANK_FWD_HPP
+#define LOO_QUEUE_BENCHMARK_KOGAN_PETRANK_FWD_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "hazard_pointers/hazard_pointers.hpp"
+#include "looqueue/align.hpp"
+#include "queues/queue_ref.hpp"
+
+namespace kpq {
+/**
+ * Implementation of the wait-free queue by Kogan & Petrank.
+ *
+ * Every operation first tries to complete on a fast path, i.e., like in the
+ * lock-free Michael-Scott queue, for at most `MAX_FAST_PATH_TRIES` attempts.
+ * Only if all attempts fail, it falls back to the slow path, on which it
+ * announces itself with a phase number larger than all currently announced
+ * phases and then helps all pending operations with an equal or lower phase
+ * before completing its own (cf. Kogan & Petrank, "A Methodology for Creating
+ * Fast Wait-Free Data Structures", PPoPP 2012).
+ * Since operations on the fast path never help, each thread also checks the
+ * descriptor of one other thread every `HELPING_DELAY` operations and helps
+ * it, if it has been pending since the last check. This bounds the number of
+ * steps of any slow path operation by the number of threads and keeps the
+ * queue wait-free, while uncontended operations skip the phase scan and the
+ * announcement altogether.
+ *
+ * The operation descriptors are stored as 128-bit cells (updated with
+ * `cmpxchg16b`) instead of being allocated, so only the (per-element) nodes
+ * require reclamation. Each node is reference counted by the two dequeuers
+ * that use it (the one claiming it as sentinel and the one reading its
+ * element) and is retired to the hazard pointers once both are done.
+ */
+template <typename T>
+class queue {
+public:
+  using pointer = T*;
+
+  /** constructor */
+  explicit queue(std::size_t max_threads = MAX_THREADS);
+  /** destructor */
+  ~queue() noexcept;
+
+  void enqueue(pointer elem, std::size_t thread_id);
+  pointer dequeue(std::size_t thread_id);
+
+  queue(const queue&)            = delete;
+  queue(queue&&)                 = delete;
+  queue& operator=(const queue&) = delete;
+  queue& operator=(queue&&)      = delete;
+
+private:
+  static constexpr std::size_t MAX_THREADS = 128;
+  /** the number of failed fast path attempts before falling back */
+  static constexpr std::size_t MAX_FAST_PATH_TRIES = 8;
+  /** the number of operations of each thread between two checks of another
+   *  thread's descriptor */
+  static constexpr std::size_t HELPING_DELAY = 32;
+  /** hazard pointers and retire threshold */
+  static constexpr std::size_t HP_TAIL = 0;
+  static constexpr std::size_t HP_NEXT = 1;
+  static constexpr std::size_t HP_HEAD = 2;
+  static constexpr std::size_t HP_COUNT = 3;
+  static constexpr std::size_t HP_SCAN_THRESHOLD = 100;
+  /** sentinel value for nodes not (yet) claimed by any dequeuer */
+  static constexpr std::int64_t NO_THREAD = -1;
+  /** dequeuer id of nodes claimed on the fast path, i.e., without a
+   *  descriptor to complete */
+  static constexpr std::int64_t FAST_PATH_THREAD = -2;
+  /** enqueuer id of nodes appended on the fast path */
+  static constexpr std::size_t NO_ENQUEUER = SIZE_MAX;
+  /** ordering constants */
+  static constexpr auto relaxed = std::memory_order_relaxed;
+  static constexpr auto acquire = std::memory_order_acquire;
+  static constexpr auto release = std::memory_order_release;
+  static constexpr auto acq_rel = std::memory_order_acq_rel;
+
+  struct node_t {
+    node_t(pointer elem, std::size_t enq_tid, std::uint32_t refs) :
+      elem{ elem }, enq_tid{ enq_tid }, refs{ refs } {}
+
+    const pointer               elem;
+    /** only written before the node is published */
+    std::size_t                 enq_tid;
+    std::atomic<std::int64_t>   deq_tid{ NO_THREAD };
+    std::atomic<std::uint32_t>  refs;
+    std::atomic<node_t*>        next{ nullptr };
+  };
+
+  /** decomposed operation descriptor */
+  struct op_desc_t {
+    std::uint64_t phase;
+    bool          pending;
+    bool          enqueue;
+    node_t*       node;
+
+    [[nodiscard]] std::uint64_t compose() const noexcept;
+    static op_desc_t decompose(std::uint64_t state, node_t* node) noexcept;
+  };
+
+  /** atomic operation descriptor, each stored on its own cache line */
+  struct alignas(CACHE_LINE_SIZE) state_cell_t {
+    std::atomic<std::uint64_t> state{ 0 };
+    std::atomic<node_t*>       node{ nullptr };
+
+    /** reads both words individually, i.e., the result may be torn, which
+     *  causes any subsequent CAS using it as expected value to fail */
+    [[nodiscard]] op_desc_t load() const noexcept;
+    bool compare_exchange(const op_desc_t& expected, const op_desc_t& desired) noexcept;
+    void store(const op_desc_t& desired) noexcept;
+  };
+
+  /** the state of a thread's periodic check of other threads' descriptors,
+   *  which is only accessed by the thread itself */
+  struct alignas(CACHE_LINE_SIZE) help_record_t {
+    std::size_t   tid{ 0 };
+    std::uint64_t phase{ 0 };
+    std::size_t   countdown{ HELPING_DELAY };
+  };
+
+  using hazard_pointers_t = memory::hazard_pointers<node_t>;
+
+  /** raises the number of descriptors scanned by other threads if required */
+  void register_thread(std::size_t thread_id);
+  /** helps the next checked thread, if its operation is still pending */
+  void help_if_needed(std::size_t thread_id);
+  bool try_fast_enqueue(node_t* node, std::size_t thread_id);
+  /** returns false, if all attempts have failed, otherwise `res` is the
+   *  dequeued element or nullptr, if the queue was found to be empty */
+  bool try_fast_dequeue(pointer& res, std::size_t thread_id);
+  std::uint64_t max_phase() const;
+  bool is_still_pending(std::size_t tid, std::uint64_t phase) const;
+  void help(std::uint64_t phase, std::size_t thread_id);
+  void help_enq(std::size_t tid, std::uint64_t phase, std::size_t thread_id);
+  void help_finish_enq(std::size_t thread_id);
+  void help_deq(std::size_t tid, std::uint64_t phase, std::size_t thread_id);
+  void help_finish_deq(std::size_t thread_id);
+  /** drops one reference to the node, retiring it when none are left */
+  void release_node(node_t* node, std::size_t thread_id);
+
+  alignas(CACHE_LINE_ALIGN) std::atomic<node_t*>     m_head;
+  alignas(CACHE_LINE_ALIGN) std::atomic<node_t*>     m_tail;
+  alignas(CACHE_LINE_ALIGN) std::atomic<std::size_t> m_active_threads{ 0 };
+  alignas(CACHE_LINE_ALIGN) std::vector<state_cell_t> m_states;
+  alignas(CACHE_LINE_ALIGN) std::vector<help_record_t> m_help_records;
+  alignas(CACHE_LINE_ALIGN) hazard_pointers_t         m_hazard_ptrs;
+};
+
+template <typename T>
+using queue_ref = queue_ref<queue<T>>;
+}
+
+#endif /* LOO_QUEUE_BENCHMARK_KOGAN_PETRANK_FWD_HPP */
@@ -3,11 +3,13 @@
 
 #include "queues/lcr/lcrq_fwd.hpp"
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <stdexcept>
 
 #include "looqueue/align.hpp"
+#include "queue_events.hpp"
 
 namespace lcr {
 namespace detail {
@@ -76,6 +78,8 @@ public:
   bool try_enqueue(pointer elem) noexcept;
   bool try_dequeue(pointer& result) noexcept;
   void fix_state();
+  /** returns the difference between tail and head ticket (at most RING_SIZE) */
+  [[nodiscard]] std::size_t approx_size() const noexcept;
 
   crq_t(const crq_t&)                      = delete;
   crq_t(crq_t&&) noexcept                  = delete;
@@ -153,6 +157,11 @@ bool queue<T>::crq_t::try_enqueue(pointer elem) noexcept {
         static_cast<std::int64_t>(tail_ticket) -
         static_cast<std::int64_t>(head_ticket) >= RING_SIZE;
     if (cmp || attempts >= PATIENCE) {
+      QUEUE_EVENT(RING_CLOSE);
+      if (!cmp) {
+        QUEUE_EVENT(PATIENCE_EXHAUSTED);
+      }
+
       this->m_tail_ticket.fetch_or(STATUS_BIT);
       return false;
     }
@@ -220,8 +229,22 @@ bool queue<T>::crq_t::try_dequeue(pointer& result) noexcept {
   }
 }
 
+template <typename T>
+std::size_t queue<T>::crq_t::approx_size() const noexcept {
+  const auto head_ticket = this->m_head_ticket.load(relaxed);
+  const auto [is_closed, tail_idx] = decomposed_idx_t{ this->m_tail_ticket.load(relaxed) };
+  // a ring is only closed by an enqueue, which failed to use its own ticket
+  const auto tail_ticket = is_closed == STATUS_BIT ? tail_idx - 1 : tail_idx;
+  if (tail_ticket <= head_ticket) {
+    return 0;
+  }
+
+  return std::min<std::size_t>(tail_ticket - head_ticket, RING_SIZE);
+}
+
 template <typename T>
 void queue<T>::crq_t::fix_state() {
+  QUEUE_EVENT(FIX_STATE);
   while (true) {
     auto tail_ticket = this->m_tail_ticket.fetch_add(0);
     const auto head_ticket = this->m_head_ticket.fetch_add(0);
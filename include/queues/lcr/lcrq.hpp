@@ -4,7 +4,9 @@
 #include "lcrq_fwd.hpp"
 
 #include <atomic>
+#include <cstdint>
 
+#include "queue_events.hpp"
 #include "queues/lcr/detail/crq.hpp"
 
 namespace lcr {
@@ -15,6 +17,8 @@ struct queue<T>::crq_node_t {
 
   crq_t ring{ };
   std::atomic<crq_node_t*> next{ nullptr };
+  /** position in the list of rings, set before the node is linked */
+  std::uint64_t seq{ 0 };
 
   bool cas_next(
       crq_node_t* expected,
@@ -70,13 +74,18 @@ void queue<T>::enqueue(queue::pointer elem, std::size_t thread_id) {
       break;
     }
 
+    // the tail ring is closed, append a new ring
+    QUEUE_EVENT(SLOW_PATH);
     auto node = new crq_node_t(elem);
+    QUEUE_EVENT(SEGMENT_ALLOC);
+    node->seq = tail->seq + 1;
 
     if (tail->cas_next(nullptr, node, release)) {
       this->m_tail.compare_exchange_strong(tail, node, release, relaxed);
       break;
     }
 
+    QUEUE_EVENT(LOST_CAS_NEXT);
     delete node;
   }
 
@@ -100,6 +109,7 @@ typename queue<T>::pointer queue<T>::dequeue(std::size_t thread_id) {
       break;
     }
 
+    QUEUE_EVENT(SLOW_PATH);
     if (head->next.load(relaxed) == nullptr) {
       res = nullptr;
       break;
@@ -118,6 +128,27 @@ typename queue<T>::pointer queue<T>::dequeue(std::size_t thread_id) {
   this->m_hazard_pointers.clear_one(thread_id, HP_DEQ_HEAD);
   return res;
 }
+
+template <typename T>
+std::size_t queue<T>::approx_size(std::size_t thread_id) {
+  // the tail and head are read one after the other (using the same hazard
+  // pointer), so the result is no atomic snapshot; all rings in between are
+  // assumed to be full, although they may have been closed early
+  const auto tail = this->m_hazard_pointers.protect(this->m_tail, thread_id, HP_ENQ_TAIL);
+  const auto tail_seq  = tail->seq;
+  const auto tail_size = tail->ring.approx_size();
+
+  const auto head = this->m_hazard_pointers.protect(this->m_head, thread_id, HP_DEQ_HEAD);
+  const auto head_seq  = head->seq;
+  const auto head_size = head->ring.approx_size();
+
+  this->m_hazard_pointers.clear_one(thread_id, HP_DEQ_HEAD);
+  if (tail_seq <= head_seq) {
+    return head_size;
+  }
+
+  return head_size + tail_size + (tail_seq - head_seq - 1) * RING_SIZE;
+}
 }
 
 #endif /* LOO_QUEUE_BENCHMARK_LCRQ_HPP */
@@ -40,6 +40,9 @@ public:
 
   void enqueue(pointer elem, std::size_t thread_id);
   pointer dequeue(std::size_t thread_id);
+  /** returns the approximate number of enqueued elements, based only on the
+   *  tickets and sequence numbers of the current head and tail rings */
+  std::size_t approx_size(std::size_t thread_id);
 
   queue(const queue&)             = delete;
   queue(queue&&)                  = delete;
@@ -2,6 +2,7 @@
 #define LOO_QUEUE_BENCHMARK_LSCQ_HPP
 
 #include <atomic>
+#include <cstdint>
 #include <stdexcept>
 
 #include "hazard_pointers/hazard_pointers.hpp"
@@ -50,6 +51,10 @@ public:
 
   void enqueue(pointer elem, std::size_t thread_id);
   pointer dequeue(std::size_t thread_id);
+  /** returns the approximate number of enqueued elements with node granularity,
+   *  since the bounded queues do not expose their head and tail indices, i.e.,
+   *  the head node is assumed empty and all nodes after it are assumed full */
+  std::size_t approx_size(std::size_t thread_id);
 
   queue(const queue&)             = delete;
   queue(queue&&)                  = delete;
@@ -70,6 +75,8 @@ struct node_t {
 
   bounded_queue_t bounded_queue{ };
   std::atomic<node_t*> next{ nullptr };
+  /** position in the list of nodes, set before the node is linked */
+  std::uint64_t seq{ 0 };
 
   bool cas_next(
       node_t* expected,
@@ -134,6 +141,7 @@ void queue<T, N>::enqueue(pointer elem, std::size_t thread_id) {
     }
 
     auto node = new node_t{ elem };
+    node->seq = tail->seq + 1;
 
     if (tail->cas_next(nullptr, node, release)) {
       this->m_tail.compare_exchange_strong(tail, node, release, relaxed);
@@ -183,6 +191,21 @@ typename queue<T, N>::pointer queue<T, N>::dequeue(std::size_t thread_id) {
   this->m_hazard_pointers.clear_one(thread_id, HP_DEQ_HEAD);
   return result;
 }
+
+template <typename T, template <typename> typename N>
+std::size_t queue<T, N>::approx_size(std::size_t thread_id) {
+  const auto tail = this->m_hazard_pointers.protect(this->m_tail, thread_id, HP_ENQ_TAIL);
+  const auto tail_seq = tail->seq;
+  const auto head = this->m_hazard_pointers.protect(this->m_head, thread_id, HP_DEQ_HEAD);
+  const auto head_seq = head->seq;
+  this->m_hazard_pointers.clear_one(thread_id, HP_DEQ_HEAD);
+
+  if (tail_seq <= head_seq) {
+    return 0;
+  }
+
+  return (tail_seq - head_seq) * node_t::bounded_queue_t::CAPACITY;
+}
 }
 
 #endif /* LOO_QUEUE_BENCHMARK_LSCQ_HPP */
@@ -0,0 +1,249 @@
+#ifndef LOO_QUEUE_BENCHMARK_MPSC_SEGMENT_HPP
+#define LOO_QUEUE_BENCHMARK_MPSC_SEGMENT_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "looqueue/align.hpp"
+#include "queues/queue_ref.hpp"
+
+namespace mpsc {
+/**
+ * Unbounded multi-producer/single-consumer queue of linked array segments.
+ *
+ * Producers reserve slots with a FAA on the tail segment's enqueue index like
+ * in `faa::queue`, but since there is only one consumer, no dequeue index is
+ * shared and slots are never abandoned: a reserved slot is simply re-read by
+ * the consumer until the producer's write becomes visible.
+ * Consequently, the consumer may report the queue as empty while a slower
+ * producer has reserved but not yet written the next slot.
+ *
+ * Instead of hazard pointers, the consumer owns all reclamation: producers
+ * only announce (in their own per-thread epoch counter) that they are inside
+ * an enqueue and the consumer frees a retired segment once every producer that
+ * was active at the time of its retirement has since left its operation.
+ */
+template <typename T>
+class queue {
+public:
+  using pointer = T*;
+
+  /** role restrictions checked by the benchmarks */
+  static constexpr bool SINGLE_PRODUCER = false;
+  static constexpr bool SINGLE_CONSUMER = true;
+
+  /** constructor */
+  explicit queue(std::size_t max_threads = MAX_THREADS);
+  /** destructor */
+  ~queue() noexcept;
+
+  void enqueue(pointer elem, std::size_t thread_id);
+  /** must only ever be called by one thread at a time, `thread_id` is ignored */
+  pointer dequeue(std::size_t thread_id);
+
+  queue(const queue&)            = delete;
+  queue(queue&&)                 = delete;
+  queue& operator=(const queue&) = delete;
+  queue& operator=(queue&&)      = delete;
+
+private:
+  /** queue node size and thread limit */
+  static constexpr std::size_t NODE_SIZE   = 1024;
+  static constexpr std::size_t MAX_THREADS = 128;
+  /** ordering constants */
+  static constexpr auto relaxed = std::memory_order_relaxed;
+  static constexpr auto acquire = std::memory_order_acquire;
+  static constexpr auto release = std::memory_order_release;
+  static constexpr auto seq_cst = std::memory_order_seq_cst;
+
+  struct node_t {
+    using slot_array_t = std::array<std::atomic<pointer>, NODE_SIZE>;
+
+    slot_array_t               slots{ };
+    std::atomic<std::uint32_t> enq_idx{ 0 };
+    std::atomic<node_t*>       next{ nullptr };
+
+    node_t() {
+      for (auto& slot : this->slots) {
+        slot.store(nullptr, relaxed);
+      }
+    }
+
+    explicit node_t(pointer first) : node_t() {
+      this->enq_idx.store(1, relaxed);
+      this->slots[0].store(first, relaxed);
+    }
+
+    bool cas_next(node_t* expected, node_t* desired, std::memory_order order) {
+      return this->next.compare_exchange_strong(expected, desired, order, relaxed);
+    }
+  };
+
+  /** each producer's epoch is odd while it is inside an enqueue operation */
+  struct alignas(CACHE_LINE_ALIGN) producer_t {
+    std::atomic<std::uint64_t> epoch{ 0 };
+  };
+
+  /** retired node and snapshot of all producer epochs at its retirement */
+  struct retired_t {
+    node_t*                    node;
+    std::vector<std::uint64_t> epochs;
+  };
+
+  bool cas_tail(node_t* expected, node_t* desired, std::memory_order order);
+  /** retires the consumed head node, the consumer must not access it anymore */
+  void retire(node_t* head, node_t* next);
+  /** frees all retired nodes no producer can access anymore */
+  void reclaim();
+
+  alignas(CACHE_LINE_ALIGN) std::atomic<node_t*> m_tail;
+  /** consumer-owned state */
+  alignas(CACHE_LINE_ALIGN) node_t*    m_head;
+  std::size_t                          m_deq_idx{ 0 };
+  std::vector<retired_t>               m_retired{ };
+  alignas(CACHE_LINE_ALIGN) std::vector<producer_t> m_producers;
+};
+
+template <typename T>
+using queue_ref = queue_ref<queue<T>>;
+
+template <typename T>
+queue<T>::queue(std::size_t max_threads) : m_producers(max_threads) {
+  auto head = new node_t();
+  this->m_head = head;
+  this->m_tail.store(head, relaxed);
+}
+
+template <typename T>
+queue<T>::~queue() noexcept {
+  for (auto& retired : this->m_retired) {
+    delete retired.node;
+  }
+
+  auto curr = this->m_head;
+  while (curr != nullptr) {
+    const auto next = curr->next.load(relaxed);
+    delete curr;
+    curr = next;
+  }
+}
+
+template <typename T>
+void queue<T>::enqueue(queue::pointer elem, std::size_t thread_id) {
+  if (elem == nullptr) [[unlikely]] {
+    throw std::invalid_argument("enqueue element must not be null");
+  }
+
+  // announce the operation before loading the tail, pairs with the tail CAS
+  // and epoch snapshot in `retire`
+  auto& epoch = this->m_producers[thread_id].epoch;
+  const auto curr_epoch = epoch.load(relaxed);
+  epoch.store(curr_epoch + 1, seq_cst);
+
+  while (true) {
+    const auto tail = this->m_tail.load(seq_cst);
+    const auto idx = tail->enq_idx.fetch_add(1, relaxed);
+    if (idx < NODE_SIZE) [[likely]] {
+      // ** fast path ** the slot can never be abandoned, so no CAS is required
+      tail->slots[idx].store(elem, release);
+      break;
+    }
+
+    // ** slow path ** append new tail node or update the tail pointer
+    const auto next = tail->next.load(acquire);
+    if (next == nullptr) {
+      auto node = new node_t(elem);
+      if (tail->cas_next(nullptr, node, release)) {
+        this->cas_tail(tail, node, release);
+        break;
+      }
+
+      delete node;
+    } else {
+      this->cas_tail(tail, next, release);
+    }
+  }
+
+  epoch.store(curr_epoch + 2, release);
+}
+
+template <typename T>
+typename queue<T>::pointer queue<T>::dequeue(std::size_t thread_id) {
+  (void) thread_id;
+  if (this->m_deq_idx == NODE_SIZE) {
+    const auto next = this->m_head->next.load(acquire);
+    if (next == nullptr) {
+      return nullptr;
+    }
+
+    this->retire(this->m_head, next);
+    this->m_head    = next;
+    this->m_deq_idx = 0;
+  }
+
+  // the slot is either still empty or was already reserved by a producer that
+  // has not yet completed its write
+  const auto res = this->m_head->slots[this->m_deq_idx].load(acquire);
+  if (res == nullptr) {
+    return nullptr;
+  }
+
+  this->m_deq_idx += 1;
+  return res;
+}
+
+template <typename T>
+bool queue<T>::cas_tail(queue::node_t* expected, queue::node_t* desired, std::memory_order order) {
+  return this->m_tail.compare_exchange_strong(expected, desired, order, relaxed);
+}
+
+template <typename T>
+void queue<T>::retire(queue::node_t* head, queue::node_t* next) {
+  // producers arriving after this point can no longer load the retired node
+  // from the tail pointer, so only those currently active have to be awaited
+  this->cas_tail(head, next, seq_cst);
+
+  std::vector<std::uint64_t> epochs{};
+  epochs.reserve(this->m_producers.size());
+  for (const auto& producer : this->m_producers) {
+    epochs.push_back(producer.epoch.load(seq_cst));
+  }
+
+  this->m_retired.push_back({ head, std::move(epochs) });
+  this->reclaim();
+}
+
+template <typename T>
+void queue<T>::reclaim() {
+  const auto is_quiescent = [&](const retired_t& retired) {
+    for (std::size_t idx = 0; idx < retired.epochs.size(); ++idx) {
+      const auto epoch = retired.epochs[idx];
+      if (epoch % 2 == 1 && this->m_producers[idx].epoch.load(acquire) == epoch) {
+        return false;
+      }
+    }
+
+    return true;
+  };
+
+  std::size_t curr = 0;
+  while (curr < this->m_retired.size()) {
+    if (is_quiescent(this->m_retired[curr])) {
+      delete this->m_retired[curr].node;
+      if (curr != this->m_retired.size() - 1) {
+        this->m_retired[curr] = std::move(this->m_retired.back());
+      }
+
+      this->m_retired.pop_back();
+      continue;
+    }
+
+    ++curr;
+  }
+}
+}
+
+#endif /* LOO_QUEUE_BENCHMARK_MPSC_SEGMENT_HPP */
@@ -0,0 +1,57 @@
+#ifndef LOO_QUEUE_BENCHMARK_MUTEX_DEQUE_HPP
+#define LOO_QUEUE_BENCHMARK_MUTEX_DEQUE_HPP
+
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+
+#include "looqueue/align.hpp"
+#include "queues/queue_ref.hpp"
+
+namespace mtx {
+/** Lock-based baseline queue: a `std::deque` protected by a `std::mutex`. */
+template <typename T>
+class queue {
+public:
+  using pointer = T*;
+
+  queue() = default;
+
+  void enqueue(pointer elem, std::size_t thread_id) {
+    (void) thread_id;
+    if (elem == nullptr) [[unlikely]] {
+      throw std::invalid_argument("enqueue element must not be null");
+    }
+
+    std::lock_guard guard{ this->m_mutex };
+    this->m_deque.push_back(elem);
+  }
+
+  pointer dequeue(std::size_t thread_id) {
+    (void) thread_id;
+    std::lock_guard guard{ this->m_mutex };
+    if (this->m_deque.empty()) {
+      return nullptr;
+    }
+
+    const auto res = this->m_deque.front();
+    this->m_deque.pop_front();
+
+    return res;
+  }
+
+  queue(const queue&)            = delete;
+  queue(queue&&)                 = delete;
+  queue& operator=(const queue&) = delete;
+  queue& operator=(queue&&)      = delete;
+
+private:
+  alignas(CACHE_LINE_ALIGN) std::mutex m_mutex{ };
+  std::deque<pointer>                  m_deque{ };
+};
+
+template <typename T>
+using queue_ref = queue_ref<queue<T>>;
+}
+
+#endif /* LOO_QUEUE_BENCHMARK_MUTEX_DEQUE_HPP */
@@ -0,0 +1,97 @@
+#ifndef LOO_QUEUE_BENCHMARK_SEQ_RING_BUFFER_HPP
+#define LOO_QUEUE_BENCHMARK_SEQ_RING_BUFFER_HPP
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+
+namespace seq {
+/**
+ * Sequential (not thread-safe) FIFO ring buffer of pointers, which doubles its
+ * capacity whenever it becomes full.
+ *
+ * Intended to be used as the backing storage of queues that serialize all
+ * accesses (e.g., through a lock or a combiner thread).
+ */
+template <typename T>
+class ring_buffer final {
+public:
+  using pointer = T*;
+
+  /** initial ring capacity, must be a power of two */
+  static constexpr std::size_t DEFAULT_CAPACITY = 1024;
+
+  /** constructor */
+  explicit ring_buffer(std::size_t capacity = DEFAULT_CAPACITY) :
+    m_slots{ std::make_unique<pointer[]>(capacity) },
+    m_mask{ capacity - 1 }
+  {
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+      throw std::invalid_argument("ring buffer capacity must be a power of two");
+    }
+  }
+
+  [[nodiscard]] bool empty() const noexcept {
+    return this->m_head == this->m_tail;
+  }
+
+  [[nodiscard]] std::size_t size() const noexcept {
+    return this->m_tail - this->m_head;
+  }
+
+  [[nodiscard]] std::size_t capacity() const noexcept {
+    return this->m_mask + 1;
+  }
+
+  /** appends the given pointer, growing the ring if it is full */
+  void push_back(pointer elem) {
+    if (this->size() == this->capacity()) [[unlikely]] {
+      this->grow();
+    }
+
+    this->m_slots[this->m_tail & this->m_mask] = elem;
+    this->m_tail += 1;
+  }
+
+  /** removes and returns the first pointer or nullptr, if the ring is empty */
+  pointer pop_front() noexcept {
+    if (this->empty()) {
+      return nullptr;
+    }
+
+    const auto res = this->m_slots[this->m_head & this->m_mask];
+    this->m_head += 1;
+
+    return res;
+  }
+
+  ring_buffer(const ring_buffer&)            = delete;
+  ring_buffer(ring_buffer&&)                 = delete;
+  ring_buffer& operator=(const ring_buffer&) = delete;
+  ring_buffer& operator=(ring_buffer&&)      = delete;
+
+private:
+  /** doubles the ring's capacity and moves all pointers to the front */
+  void grow() {
+    const auto size     = this->size();
+    const auto capacity = 2 * this->capacity();
+    auto slots = std::make_unique<pointer[]>(capacity);
+
+    for (std::size_t idx = 0; idx < size; ++idx) {
+      slots[idx] = this->m_slots[(this->m_head + idx) & this->m_mask];
+    }
+
+    this->m_slots = std::move(slots);
+    this->m_mask  = capacity - 1;
+    this->m_head  = 0;
+    this->m_tail  = size;
+  }
+
+  std::unique_ptr<pointer[]> m_slots;
+  std::size_t m_mask;
+  std::size_t m_head{ 0 };
+  std::size_t m_tail{ 0 };
+};
+}
+
+#endif /* LOO_QUEUE_BENCHMARK_SEQ_RING_BUFFER_HPP */
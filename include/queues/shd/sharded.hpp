@@ -0,0 +1,103 @@
+#ifndef LOO_QUEUE_BENCHMARK_SHARDED_HPP
+#define LOO_QUEUE_BENCHMARK_SHARDED_HPP
+
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "looqueue/align.hpp"
+#include "queues/faa/faa_array.hpp"
+#include "queues/lcr/lcrq.hpp"
+#include "queues/queue_ref.hpp"
+
+namespace shd {
+/**
+ * Relaxed (non-linearizable) MPMC queue, which distributes its elements over
+ * several independent FIFO queues (shards).
+ *
+ * Each thread enqueues into the shard it is affine to, so that the per-shard
+ * enqueue indices are only contended by a fraction of all threads.
+ * Dequeuers sweep over all shards in round-robin order, starting at the shard
+ * they last dequeued from, and only report the queue as empty if every shard
+ * was found to be empty during the sweep.
+ * Elements enqueued by the same thread are dequeued in FIFO order.
+ */
+template <typename Q>
+class queue {
+public:
+  using shard_queue = Q;
+  using pointer     = typename Q::pointer;
+
+  static constexpr std::size_t DEFAULT_SHARDS = 8;
+
+  /** constructor */
+  explicit queue(std::size_t shards = DEFAULT_SHARDS, std::size_t max_threads = MAX_THREADS) :
+    m_cursors(max_threads)
+  {
+    if (shards == 0) {
+      throw std::invalid_argument("sharded queue requires at least one shard");
+    }
+
+    this->m_shards.reserve(shards);
+    for (std::size_t shard = 0; shard < shards; ++shard) {
+      this->m_shards.push_back(std::make_unique<shard_queue>(max_threads));
+    }
+
+    for (std::size_t thread = 0; thread < max_threads; ++thread) {
+      this->m_cursors[thread].shard = this->home_shard(thread);
+    }
+  }
+
+  void enqueue(pointer elem, std::size_t thread_id) {
+    this->m_shards[this->home_shard(thread_id)]->enqueue(elem, thread_id);
+  }
+
+  pointer dequeue(std::size_t thread_id) {
+    const auto shards = this->m_shards.size();
+    auto& cursor = this->m_cursors[thread_id].shard;
+
+    for (std::size_t i = 0; i < shards; ++i) {
+      const auto shard = (cursor + i) % shards;
+      const auto res = this->m_shards[shard]->dequeue(thread_id);
+      if (res != nullptr) {
+        cursor = shard;
+        return res;
+      }
+    }
+
+    return nullptr;
+  }
+
+  queue(const queue&)            = delete;
+  queue(queue&&)                 = delete;
+  queue& operator=(const queue&) = delete;
+  queue& operator=(queue&&)      = delete;
+
+private:
+  static constexpr std::size_t MAX_THREADS = 128;
+
+  /** each thread's dequeue cursor is stored on its own cache line */
+  struct alignas(CACHE_LINE_ALIGN) cursor_t {
+    std::size_t shard{ 0 };
+  };
+
+  [[nodiscard]] std::size_t home_shard(std::size_t thread_id) const noexcept {
+    return thread_id % this->m_shards.size();
+  }
+
+  std::vector<std::unique_ptr<shard_queue>> m_shards{ };
+  std::vector<cursor_t>                     m_cursors;
+};
+
+template <typename T>
+using faa_queue = queue<faa::queue<T>>;
+template <typename T>
+using lcr_queue = queue<lcr::queue<T>>;
+
+template <typename T>
+using faa_queue_ref = queue_ref<faa_queue<T>>;
+template <typename T>
+using lcr_queue_ref = queue_ref<lcr_queue<T>>;
+}
+
+#endif /* LOO_QUEUE_BENCHMARK_SHARDED_HPP */
@@ -0,0 +1,499 @@
+#ifndef LOO_QUEUE_BENCHMARK_SHM_FAA_ARRAY_HPP
+#define LOO_QUEUE_BENCHMARK_SHM_FAA_ARRAY_HPP
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "looqueue/align.hpp"
+
+namespace shm {
+/**
+ * Process-shared variant of the FAAArrayQueue by Correia & Ramalhete, which
+ * lives entirely inside a named (`shm_open`) shared memory mapping.
+ *
+ * Since the mapping may be attached at different addresses in each process,
+ * all links are 32-bit segment indices into an arena of pre-allocated segments
+ * following the queue's header instead of pointers, and the queue stores plain
+ * 64-bit values instead of pointers (0 and `UINT64_MAX` are reserved).
+ * Unused segments are kept in a (tagged) free list inside the mapping.
+ *
+ * Each `queue` object is a process-local handle which registers itself as one
+ * participant in the mapping and must only be used by one thread at a time.
+ * Segments are reclaimed with epoch-based reclamation across all registered
+ * participants, whose retired segments are also kept inside the mapping.
+ * Participants of terminated processes are detected (via `kill(pid, 0)`) and
+ * deregistered, so a crashed process can not block reclamation indefinitely.
+ */
+class queue {
+public:
+  using value_type = std::uint64_t;
+
+  static constexpr std::size_t SEGMENT_SIZE     = 1024;
+  static constexpr std::size_t DEFAULT_SEGMENTS = 1024;
+  static constexpr std::size_t MAX_PARTICIPANTS = 64;
+
+  /** creates and initializes the named shared memory queue */
+  queue(const std::string& name, std::size_t segments);
+  /** attaches to the existing named shared memory queue */
+  explicit queue(const std::string& name);
+  /** destructor, deregisters and detaches from the queue */
+  ~queue() noexcept;
+
+  /** removes the name of the shared memory queue, existing mappings persist */
+  static void unlink(const std::string& name);
+
+  void enqueue(value_type value);
+  /** returns 0, if the queue is empty */
+  value_type dequeue();
+
+  queue(const queue&)            = delete;
+  queue(queue&&)                 = delete;
+  queue& operator=(const queue&) = delete;
+  queue& operator=(queue&&)      = delete;
+
+private:
+  /** value tokens for empty and dequeued slots */
+  static constexpr value_type EMPTY = 0;
+  static constexpr value_type TAKEN = UINT64_MAX;
+  /** segment index representing the end of any list */
+  static constexpr std::uint32_t NIL = UINT32_MAX;
+  /** identifies initialized mappings */
+  static constexpr std::uint64_t MAGIC = 0x6c66712d73686d32;
+  /** ordering constants */
+  static constexpr auto relaxed = std::memory_order_relaxed;
+  static constexpr auto acquire = std::memory_order_acquire;
+  static constexpr auto release = std::memory_order_release;
+  static constexpr auto seq_cst = std::memory_order_seq_cst;
+
+  static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+  static_assert(std::atomic<std::uint32_t>::is_always_lock_free);
+
+  struct segment_t {
+    std::array<std::atomic<value_type>, SEGMENT_SIZE> slots;
+    alignas(CACHE_LINE_ALIGN) std::atomic<std::uint32_t> enq_idx;
+    alignas(CACHE_LINE_ALIGN) std::atomic<std::uint32_t> deq_idx;
+    alignas(CACHE_LINE_ALIGN) std::atomic<std::uint32_t> next;
+    /** link in either the free list or the list of retired segments */
+    std::atomic<std::uint32_t>                           link;
+    std::atomic<std::uint64_t>                           retire_epoch;
+  };
+
+  /** a participant's epoch is odd while it is inside an operation */
+  struct alignas(CACHE_LINE_ALIGN) participant_t {
+    std::atomic<pid_t>         pid;
+    std::atomic<std::uint64_t> epoch;
+  };
+
+  struct header_t {
+    std::atomic<std::uint64_t>                         magic;
+    std::uint64_t                                      segments;
+    alignas(CACHE_LINE_ALIGN) std::atomic<std::uint32_t> head;
+    alignas(CACHE_LINE_ALIGN) std::atomic<std::uint32_t> tail;
+    /** tagged (ABA counter in the upper 32 bits) index of the first free segment */
+    alignas(CACHE_LINE_ALIGN) std::atomic<std::uint64_t> free_list;
+    alignas(CACHE_LINE_ALIGN) std::atomic<std::uint32_t> retired;
+    /** number of segments linked into the queue and not yet retired */
+    alignas(CACHE_LINE_ALIGN) std::atomic<std::uint32_t> linked;
+    alignas(CACHE_LINE_ALIGN) std::atomic<std::uint64_t> epoch;
+    std::array<participant_t, MAX_PARTICIPANTS>          participants;
+  };
+
+  /** offset of the first segment relative to the start of the mapping */
+  static constexpr std::size_t SEGMENTS_OFFSET =
+      (sizeof(header_t) + alignof(segment_t) - 1) / alignof(segment_t) * alignof(segment_t);
+
+  static std::size_t mapping_size(std::size_t segments) {
+    return SEGMENTS_OFFSET + segments * sizeof(segment_t);
+  }
+
+  static bool is_alive(pid_t pid) {
+    return ::kill(pid, 0) == 0 || errno == EPERM;
+  }
+
+  /** maps `size` bytes of the opened shared memory object */
+  void map(int fd, std::size_t size);
+  /** claims an unused (or abandoned) participant slot */
+  void register_participant();
+
+  segment_t& segment(std::uint32_t idx) const {
+    return *reinterpret_cast<segment_t*>(this->m_base + SEGMENTS_OFFSET + idx * sizeof(segment_t));
+  }
+
+  /** pops a segment from the free list and initializes it with `first`,
+   *  returns NIL if the free list is exhausted */
+  std::uint32_t allocate_segment(value_type first);
+  void free_segment(std::uint32_t idx);
+  /** must be called outside of any operation, attempts to reclaim segments and
+   *  throws if all segments are linked into the queue, i.e., it is full */
+  void await_free_segments();
+  /** marks the calling participant as active in the current epoch */
+  void enter();
+  void leave();
+  void retire(std::uint32_t idx);
+  /** advances the global epoch, if every live participant has observed it */
+  bool try_advance_epoch();
+  /** moves all retired segments that can no longer be accessed to the free list */
+  void reclaim();
+
+  std::size_t m_size{ 0 };
+  std::byte*  m_base{ nullptr };
+  header_t*   m_header{ nullptr };
+  std::size_t m_participant{ MAX_PARTICIPANTS };
+};
+
+inline queue::queue(const std::string& name, std::size_t segments) {
+  if (segments < 2 || segments >= NIL) {
+    throw std::invalid_argument("invalid number of shared memory queue segments");
+  }
+
+  const auto fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd == -1) {
+    throw std::system_error(errno, std::generic_category(), "failed to create shared memory");
+  }
+
+  if (::ftruncate(fd, static_cast<off_t>(mapping_size(segments))) == -1) {
+    const auto err = errno;
+    ::close(fd);
+    ::shm_unlink(name.c_str());
+    throw std::system_error(err, std::generic_category(), "failed to resize shared memory");
+  }
+
+  this->map(fd, mapping_size(segments));
+
+  // the mapping is zero-initialized, which is not the initial state of any
+  // segment or list, so all objects are constructed explicitly
+  this->m_header = new (this->m_base) header_t{};
+  this->m_header->segments = segments;
+  for (std::uint32_t idx = 0; idx < segments; ++idx) {
+    auto seg = new (&this->segment(idx)) segment_t{};
+    seg->link.store(idx + 1 < segments ? idx + 1 : NIL, relaxed);
+    seg->next.store(NIL, relaxed);
+  }
+
+  // segment 0 is the initial (empty) head and tail segment
+  this->m_header->free_list.store(1, relaxed);
+  this->m_header->retired.store(NIL, relaxed);
+  this->m_header->linked.store(1, relaxed);
+  this->m_header->head.store(0, relaxed);
+  this->m_header->tail.store(0, relaxed);
+  this->m_header->magic.store(MAGIC, release);
+
+  this->register_participant();
+}
+
+inline queue::queue(const std::string& name) {
+  const auto fd = ::shm_open(name.c_str(), O_RDWR, 0600);
+  if (fd == -1) {
+    throw std::system_error(errno, std::generic_category(), "failed to open shared memory");
+  }
+
+  struct stat info{};
+  if (::fstat(fd, &info) == -1 || static_cast<std::size_t>(info.st_size) < sizeof(header_t)) {
+    ::close(fd);
+    throw std::runtime_error("shared memory is too small for a queue");
+  }
+
+  this->map(fd, static_cast<std::size_t>(info.st_size));
+  this->m_header = reinterpret_cast<header_t*>(this->m_base);
+  if (
+      this->m_header->magic.load(acquire) != MAGIC
+      || mapping_size(this->m_header->segments) > this->m_size
+  ) {
+    ::munmap(this->m_base, this->m_size);
+    throw std::runtime_error("shared memory does not contain an initialized queue");
+  }
+
+  this->register_participant();
+}
+
+inline queue::~queue() noexcept {
+  auto& participant = this->m_header->participants[this->m_participant];
+  participant.epoch.store(0, relaxed);
+  participant.pid.store(0, release);
+  ::munmap(this->m_base, this->m_size);
+}
+
+inline void queue::unlink(const std::string& name) {
+  if (::shm_unlink(name.c_str()) == -1) {
+    throw std::system_error(errno, std::generic_category(), "failed to unlink shared memory");
+  }
+}
+
+inline void queue::enqueue(queue::value_type value) {
+  if (value == EMPTY || value == TAKEN) [[unlikely]] {
+    throw std::invalid_argument("enqueue value must not be 0 or UINT64_MAX");
+  }
+
+  this->enter();
+  while (true) {
+    const auto tail_idx = this->m_header->tail.load(acquire);
+    auto& tail = this->segment(tail_idx);
+    const auto idx = tail.enq_idx.fetch_add(1, relaxed);
+    if (idx < SEGMENT_SIZE) [[likely]] {
+      // ** fast path ** write value into the reserved slot
+      auto expected = EMPTY;
+      if (tail.slots[idx].compare_exchange_strong(expected, value, release, relaxed)) {
+        break;
+      }
+
+      continue;
+    }
+
+    // ** slow path ** append new tail segment or update the tail index
+    if (tail_idx != this->m_header->tail.load(acquire)) {
+      continue;
+    }
+
+    const auto next = tail.next.load(acquire);
+    if (next == NIL) {
+      const auto seg_idx = this->allocate_segment(value);
+      if (seg_idx == NIL) {
+        // the own (active) epoch would prevent the reclamation of any segment
+        // retired after this operation began
+        this->leave();
+        this->await_free_segments();
+        this->enter();
+        continue;
+      }
+
+      auto expected = NIL;
+      if (tail.next.compare_exchange_strong(expected, seg_idx, release, relaxed)) {
+        this->m_header->linked.fetch_add(1, relaxed);
+        auto expected_tail = tail_idx;
+        this->m_header->tail.compare_exchange_strong(expected_tail, seg_idx, release, relaxed);
+        break;
+      }
+
+      // the segment was never linked, so it can be freed immediately
+      this->free_segment(seg_idx);
+    } else {
+      auto expected_tail = tail_idx;
+      this->m_header->tail.compare_exchange_strong(expected_tail, next, release, relaxed);
+    }
+  }
+
+  this->leave();
+}
+
+inline queue::value_type queue::dequeue() {
+  value_type res = EMPTY;
+
+  this->enter();
+  while (true) {
+    const auto head_idx = this->m_header->head.load(acquire);
+    auto& head = this->segment(head_idx);
+    if (
+        head.deq_idx.load(relaxed) >= head.enq_idx.load(relaxed)
+        && head.next.load(relaxed) == NIL
+    ) {
+      break;
+    }
+
+    const auto idx = head.deq_idx.fetch_add(1, relaxed);
+    if (idx < SEGMENT_SIZE) {
+      // ** fast path ** read value, abandons the slot if it is still empty
+      const auto value = head.slots[idx].exchange(TAKEN, acquire);
+      if (value == EMPTY) {
+        continue;
+      }
+
+      res = value;
+      break;
+    }
+
+    // ** slow path ** advance the head index to the next segment
+    const auto next = head.next.load(acquire);
+    if (next == NIL) {
+      break;
+    }
+
+    // the tail must not lag behind the head, otherwise enqueuers could still
+    // load the index of a retired segment from it
+    auto expected_tail = head_idx;
+    this->m_header->tail.compare_exchange_strong(expected_tail, next, release, relaxed);
+
+    auto expected_head = head_idx;
+    if (this->m_header->head.compare_exchange_strong(expected_head, next, release, relaxed)) {
+      this->retire(head_idx);
+    }
+  }
+
+  this->leave();
+  return res;
+}
+
+inline void queue::map(int fd, std::size_t size) {
+  const auto addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  const auto err = errno;
+  ::close(fd);
+  if (addr == MAP_FAILED) {
+    throw std::system_error(err, std::generic_category(), "failed to map shared memory");
+  }
+
+  this->m_base = static_cast<std::byte*>(addr);
+  this->m_size = size;
+}
+
+inline void queue::register_participant() {
+  const auto self = ::getpid();
+  for (std::size_t idx = 0; idx < MAX_PARTICIPANTS; ++idx) {
+    auto& participant = this->m_header->participants[idx];
+    auto pid = participant.pid.load(acquire);
+    if (pid != 0 && is_alive(pid)) {
+      continue;
+    }
+
+    if (participant.pid.compare_exchange_strong(pid, self, seq_cst, relaxed)) {
+      participant.epoch.store(0, release);
+      this->m_participant = idx;
+      return;
+    }
+  }
+
+  ::munmap(this->m_base, this->m_size);
+  throw std::runtime_error("too many participants registered at shared memory queue");
+}
+
+inline std::uint32_t queue::allocate_segment(queue::value_type first) {
+  // if the free list is exhausted, retired segments are reclaimed first; since
+  // the caller is itself inside an operation, the epoch can advance at most
+  // once, which only frees segments retired before the caller entered
+  for (auto attempt = 0; attempt < 2; ++attempt) {
+    auto curr = this->m_header->free_list.load(acquire);
+    while (static_cast<std::uint32_t>(curr) != NIL) {
+      const auto idx = static_cast<std::uint32_t>(curr);
+      const auto next = this->segment(idx).link.load(relaxed);
+      const auto tagged = ((curr >> 32) + 1) << 32 | next;
+      if (this->m_header->free_list.compare_exchange_weak(curr, tagged, acquire, acquire)) {
+        auto& seg = this->segment(idx);
+        seg.slots[0].store(first, relaxed);
+        for (std::size_t slot = 1; slot < SEGMENT_SIZE; ++slot) {
+          seg.slots[slot].store(EMPTY, relaxed);
+        }
+
+        seg.enq_idx.store(1, relaxed);
+        seg.deq_idx.store(0, relaxed);
+        seg.next.store(NIL, relaxed);
+        return idx;
+      }
+    }
+
+    this->try_advance_epoch();
+    this->reclaim();
+  }
+
+  return NIL;
+}
+
+inline void queue::free_segment(std::uint32_t idx) {
+  auto curr = this->m_header->free_list.load(relaxed);
+  do {
+    this->segment(idx).link.store(static_cast<std::uint32_t>(curr), relaxed);
+  } while (!this->m_header->free_list.compare_exchange_weak(
+      curr, ((curr >> 32) + 1) << 32 | idx, release, relaxed
+  ));
+}
+
+inline void queue::await_free_segments() {
+  // any segment that is not linked is either free, retired or only popped from
+  // the free list by a concurrent enqueue, which links or frees it again, so
+  // only a queue without any such segment is exhausted
+  if (this->m_header->linked.load(acquire) >= this->m_header->segments) {
+    throw std::runtime_error("shared memory queue has run out of segments");
+  }
+
+  // other participants may be preempted inside an operation, which blocks the
+  // epoch from advancing until they resume
+  this->try_advance_epoch();
+  this->reclaim();
+  ::sched_yield();
+}
+
+inline void queue::enter() {
+  const auto epoch = this->m_header->epoch.load(acquire);
+  this->m_header->participants[this->m_participant].epoch.store(epoch << 1 | 1, seq_cst);
+}
+
+inline void queue::leave() {
+  this->m_header->participants[this->m_participant].epoch.store(0, release);
+}
+
+inline void queue::retire(std::uint32_t idx) {
+  auto& seg = this->segment(idx);
+  seg.retire_epoch.store(this->m_header->epoch.load(acquire), relaxed);
+
+  this->m_header->linked.fetch_sub(1, release);
+  auto curr = this->m_header->retired.load(relaxed);
+  do {
+    seg.link.store(curr, relaxed);
+  } while (!this->m_header->retired.compare_exchange_weak(curr, idx, release, relaxed));
+
+  this->try_advance_epoch();
+  this->reclaim();
+}
+
+inline bool queue::try_advance_epoch() {
+  auto epoch = this->m_header->epoch.load(seq_cst);
+  for (auto& participant : this->m_header->participants) {
+    auto pid = participant.pid.load(acquire);
+    const auto local = participant.epoch.load(seq_cst);
+    if (pid == 0 || local % 2 == 0 || local >> 1 == epoch) {
+      continue;
+    }
+
+    // a participant that has terminated inside an operation is deregistered
+    if (!is_alive(pid)) {
+      if (participant.pid.compare_exchange_strong(pid, 0, seq_cst, relaxed)) {
+        participant.epoch.store(0, release);
+      }
+
+      continue;
+    }
+
+    return false;
+  }
+
+  return this->m_header->epoch.compare_exchange_strong(epoch, epoch + 1, seq_cst, relaxed);
+}
+
+inline void queue::reclaim() {
+  // takes the entire list, so no concurrent reclaim can free the same segments
+  auto curr = this->m_header->retired.exchange(NIL, acquire);
+  if (curr == NIL) {
+    return;
+  }
+
+  const auto epoch = this->m_header->epoch.load(acquire);
+  while (curr != NIL) {
+    auto& seg = this->segment(curr);
+    const auto next = seg.link.load(relaxed);
+    if (seg.retire_epoch.load(relaxed) + 2 <= epoch) {
+      this->free_segment(curr);
+    } else {
+      // re-retires the segment with its original epoch
+      auto head = this->m_header->retired.load(relaxed);
+      do {
+        seg.link.store(head, relaxed);
+      } while (!this->m_header->retired.compare_exchange_weak(head, curr, release, relaxed));
+    }
+
+    curr = next;
+  }
+}
+}
+
+#endif /* LOO_QUEUE_BENCHMARK_SHM_FAA_ARRAY_HPP */
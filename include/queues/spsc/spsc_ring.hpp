@@ -0,0 +1,112 @@
+#ifndef LOO_QUEUE_BENCHMARK_SPSC_RING_HPP
+#define LOO_QUEUE_BENCHMARK_SPSC_RING_HPP
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+
+#include "looqueue/align.hpp"
+#include "queues/queue_ref.hpp"
+
+namespace spsc {
+/**
+ * Bounded single-producer/single-consumer ring buffer.
+ *
+ * Both sides keep a private copy of the other side's index and only reload the
+ * shared index once their copy indicates a full (or empty) ring, so that in
+ * the common case neither side reads the other side's cache line.
+ * No read-modify-write instructions are required on either side.
+ *
+ * The `thread_id` arguments are ignored, at most one thread may enqueue and at
+ * most one thread may dequeue at any time.
+ */
+template <typename T>
+class queue {
+public:
+  using pointer = T*;
+
+  /** role restrictions checked by the benchmarks */
+  static constexpr bool SINGLE_PRODUCER = true;
+  static constexpr bool SINGLE_CONSUMER = true;
+
+  static constexpr std::size_t DEFAULT_CAPACITY = 1 << 16;
+
+  /** constructor */
+  explicit queue(std::size_t capacity = DEFAULT_CAPACITY) :
+    m_slots{ std::make_unique<pointer[]>(capacity) },
+    m_mask{ capacity - 1 }
+  {
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+      throw std::invalid_argument("ring capacity must be a power of two");
+    }
+  }
+
+  /** attempts to enqueue the given element, fails if the ring is full */
+  bool try_enqueue(pointer elem) {
+    if (elem == nullptr) [[unlikely]] {
+      throw std::invalid_argument("enqueue element must not be null");
+    }
+
+    const auto tail = this->m_tail.load(relaxed);
+    if (tail - this->m_cached_head > this->m_mask) {
+      this->m_cached_head = this->m_head.load(acquire);
+      if (tail - this->m_cached_head > this->m_mask) {
+        return false;
+      }
+    }
+
+    this->m_slots[tail & this->m_mask] = elem;
+    this->m_tail.store(tail + 1, release);
+
+    return true;
+  }
+
+  /** enqueues the given element, spins for as long as the ring is full */
+  void enqueue(pointer elem, std::size_t thread_id) {
+    (void) thread_id;
+    while (!this->try_enqueue(elem)) {}
+  }
+
+  pointer dequeue(std::size_t thread_id) {
+    (void) thread_id;
+    const auto head = this->m_head.load(relaxed);
+    if (head == this->m_cached_tail) {
+      this->m_cached_tail = this->m_tail.load(acquire);
+      if (head == this->m_cached_tail) {
+        return nullptr;
+      }
+    }
+
+    const auto res = this->m_slots[head & this->m_mask];
+    this->m_head.store(head + 1, release);
+
+    return res;
+  }
+
+  queue(const queue&)            = delete;
+  queue(queue&&)                 = delete;
+  queue& operator=(const queue&) = delete;
+  queue& operator=(queue&&)      = delete;
+
+private:
+  /** ordering constants */
+  static constexpr auto relaxed = std::memory_order_relaxed;
+  static constexpr auto acquire = std::memory_order_acquire;
+  static constexpr auto release = std::memory_order_release;
+
+  /** consumer-owned cache line */
+  alignas(CACHE_LINE_ALIGN) std::atomic<std::size_t> m_head{ 0 };
+  std::size_t                                        m_cached_tail{ 0 };
+  /** producer-owned cache line */
+  alignas(CACHE_LINE_ALIGN) std::atomic<std::size_t> m_tail{ 0 };
+  std::size_t                                        m_cached_head{ 0 };
+  /** read-only after construction */
+  alignas(CACHE_LINE_ALIGN) std::unique_ptr<pointer[]> m_slots;
+  const std::size_t                                    m_mask;
+};
+
+template <typename T>
+using queue_ref = queue_ref<queue<T>>;
+}
+
+#endif /* LOO_QUEUE_BENCHMARK_SPSC_RING_HPP */
@@ -0,0 +1,52 @@
+#ifndef LOO_QUEUE_BENCHMARK_TICKET_RING_HPP
+#define LOO_QUEUE_BENCHMARK_TICKET_RING_HPP
+
+#include <mutex>
+#include <stdexcept>
+
+#include "locks/spinlock.hpp"
+#include "looqueue/align.hpp"
+#include "queues/queue_ref.hpp"
+#include "queues/seq/ring_buffer.hpp"
+
+namespace tkt {
+/** Lock-based baseline queue: a sequential ring buffer protected by a (fair)
+ *  ticket spin lock. */
+template <typename T>
+class queue {
+public:
+  using pointer = T*;
+
+  queue() = default;
+
+  void enqueue(pointer elem, std::size_t thread_id) {
+    (void) thread_id;
+    if (elem == nullptr) [[unlikely]] {
+      throw std::invalid_argument("enqueue element must not be null");
+    }
+
+    std::lock_guard guard{ this->m_lock };
+    this->m_ring.push_back(elem);
+  }
+
+  pointer dequeue(std::size_t thread_id) {
+    (void) thread_id;
+    std::lock_guard guard{ this->m_lock };
+    return this->m_ring.pop_front();
+  }
+
+  queue(const queue&)            = delete;
+  queue(queue&&)                 = delete;
+  queue& operator=(const queue&) = delete;
+  queue& operator=(queue&&)      = delete;
+
+private:
+  alignas(CACHE_LINE_ALIGN) locks::ticket_lock  m_lock{ };
+  alignas(CACHE_LINE_ALIGN) seq::ring_buffer<T> m_ring{ };
+};
+
+template <typename T>
+using queue_ref = queue_ref<queue<T>>;
+}
+
+#endif /* LOO_QUEUE_BENCHMARK_TICKET_RING_HPP */
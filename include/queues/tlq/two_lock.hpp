@@ -0,0 +1,109 @@
+#ifndef LOO_QUEUE_BENCHMARK_TWO_LOCK_HPP
+#define LOO_QUEUE_BENCHMARK_TWO_LOCK_HPP
+
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+
+#include "locks/spinlock.hpp"
+#include "looqueue/align.hpp"
+#include "queues/queue_ref.hpp"
+
+namespace tlq {
+/** Implementation of the two-lock queue by Michael & Scott. */
+template <typename T>
+class queue {
+public:
+  using pointer = T*;
+
+  queue();
+  ~queue() noexcept;
+  void enqueue(pointer elem, std::size_t thread_id);
+  pointer dequeue(std::size_t thread_id);
+
+  queue(const queue&)            = delete;
+  queue(queue&&)                 = delete;
+  queue& operator=(const queue&) = delete;
+  queue& operator=(queue&&)      = delete;
+
+private:
+  /** ordering constants */
+  static constexpr auto relaxed = std::memory_order_relaxed;
+  static constexpr auto acquire = std::memory_order_acquire;
+  static constexpr auto release = std::memory_order_release;
+
+  /** the `next` pointer of the sentinel node may be written by an enqueuer
+   *  while a dequeuer reads it, since both hold different locks */
+  struct node_t {
+    pointer elem;
+    std::atomic<node_t*> next{ nullptr };
+  };
+
+  /** each lock is stored on the same cache line as the pointer it protects */
+  alignas(CACHE_LINE_ALIGN) locks::ttas_lock m_head_lock{ };
+  node_t*                                    m_head;
+  alignas(CACHE_LINE_ALIGN) locks::ttas_lock m_tail_lock{ };
+  node_t*                                    m_tail;
+};
+
+template <typename T>
+using queue_ref = queue_ref<queue<T>>;
+
+template <typename T>
+queue<T>::queue() {
+  const auto sentinel = new node_t{ nullptr };
+  this->m_head = sentinel;
+  this->m_tail = sentinel;
+}
+
+template <typename T>
+queue<T>::~queue() noexcept {
+  auto curr = this->m_head;
+  while (curr != nullptr) {
+    auto next = curr->next.load(relaxed);
+    delete curr;
+    curr = next;
+  }
+}
+
+template <typename T>
+void queue<T>::enqueue(queue::pointer elem, std::size_t thread_id) {
+  (void) thread_id;
+  if (elem == nullptr) [[unlikely]] {
+    throw std::invalid_argument("enqueue element must not be null");
+  }
+
+  // allocate the node before acquiring the lock
+  auto node = new node_t{ elem };
+
+  std::lock_guard guard{ this->m_tail_lock };
+  this->m_tail->next.store(node, release);
+  this->m_tail = node;
+}
+
+template <typename T>
+typename queue<T>::pointer queue<T>::dequeue(std::size_t thread_id) {
+  (void) thread_id;
+  node_t* head;
+  pointer res;
+
+  {
+    std::lock_guard guard{ this->m_head_lock };
+    head = this->m_head;
+    const auto next = head->next.load(acquire);
+    if (next == nullptr) {
+      return nullptr;
+    }
+
+    res = next->elem;
+    this->m_head = next;
+  }
+
+  // the old sentinel can no longer be accessed by any other thread, so it can
+  // be freed outside of the critical section
+  delete head;
+  return res;
+}
+}
+
+#endif /* LOO_QUEUE_BENCHMARK_TWO_LOCK_HPP */
@@ -0,0 +1,117 @@
+#ifndef LOO_QUEUE_BENCHES_RESULTS_HPP
+#define LOO_QUEUE_BENCHES_RESULTS_HPP
+
+#include <fstream>
+#include <iostream>
+#include <span>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "common.hpp"
+
+namespace bench {
+/**
+ * Writes every line of measurements a bench prints to stdout as a structured
+ * record to the file given by `--output`, along with the metadata of the host
+ * and build and a summary of each measurement across all runs.
+ *
+ * While the writer exists, it intercepts all output to `std::cout`, which is
+ * still passed on unchanged, so the benches themselves remain unaware of it.
+ * Each line is split into its (named) columns, the first two of which are
+ * always the queue and the thread count. Since all benches execute their runs
+ * for one thread count one after another, the lines of each such block are
+ * split evenly into `runs` runs and each line's position within its run
+ * determines the variant (e.g., the mode or load) it measures.
+ */
+class results_writer {
+public:
+  results_writer(
+      bench_type_t           bench_type,
+      std::size_t            total_ops,
+      std::size_t            runs,
+      const options_t&       options,
+      std::span<char* const> args
+  );
+
+  ~results_writer() noexcept;
+
+  /** writes all records and the summary, must be called after the last run */
+  void finish();
+
+  results_writer(const results_writer&)            = delete;
+  results_writer(results_writer&&)                 = delete;
+  results_writer& operator=(const results_writer&) = delete;
+  results_writer& operator=(results_writer&&)      = delete;
+
+private:
+  /** passes all output on to the original buffer and each complete line on
+   *  to the writer */
+  class line_buf : public std::streambuf {
+  public:
+    line_buf(std::streambuf* out, std::vector<std::string>& lines) : m_out{ out }, m_lines{ lines } {}
+
+  protected:
+    int_type overflow(int_type ch) override;
+    std::streamsize xsputn(const char* str, std::streamsize count) override;
+    int sync() override;
+
+  private:
+    std::streambuf*           m_out;
+    std::vector<std::string>& m_lines;
+    std::string               m_line{ };
+  };
+
+  /** one line of measurements split into its fields */
+  struct record_t {
+    std::vector<std::string> fields;
+    std::size_t              run;
+    std::size_t              variant;
+    bool                     outlier{ false };
+  };
+
+  /** the statistics of one numeric column across all runs of one variant */
+  struct summary_t {
+    std::string              queue;
+    std::string              threads;
+    std::size_t              variant;
+    /** the non-numeric columns shared by all runs, as `<name>=<value>;...` */
+    std::string              params;
+    std::string              column;
+    std::size_t              count;
+    double                   median;
+    double                   mean;
+    double                   stddev;
+    double                   ci_low;
+    double                   ci_high;
+    /** the runs outside of Tukey's fences (1.5 times the interquartile range
+     *  below the first or above the third quartile) */
+    std::vector<std::size_t> outlier_runs;
+  };
+
+  [[nodiscard]] std::string column_name(std::size_t idx) const;
+  [[nodiscard]] std::vector<record_t> collect_records() const;
+  [[nodiscard]] std::vector<summary_t> summarize(std::vector<record_t>& records) const;
+  void write_csv(const std::vector<record_t>& records, const std::vector<summary_t>& summary);
+  void write_json(const std::vector<record_t>& records, const std::vector<summary_t>& summary);
+
+  const std::string                                m_bench;
+  const std::size_t                                m_runs;
+  const output_format_t                            m_format;
+  const std::string                                m_path;
+  const std::vector<std::string>                   m_columns;
+  std::vector<std::pair<std::string, std::string>> m_metadata{ };
+  std::ofstream                                    m_file;
+  std::vector<std::string>                         m_lines{ };
+  line_buf                                         m_buf;
+  std::streambuf*                                  m_stdout;
+};
+
+/** returns the names of the columns the given bench prints with the given
+ *  options, starting with the queue and the thread count */
+std::vector<std::string> column_names(bench_type_t bench_type, const options_t& options);
+}
+
+#endif /* LOO_QUEUE_BENCHES_RESULTS_HPP */
@@ -0,0 +1,112 @@
+#ifndef LOO_QUEUE_BENCHMARK_CHASE_LEV_HPP
+#define LOO_QUEUE_BENCHMARK_CHASE_LEV_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+
+#include "looqueue/align.hpp"
+
+namespace sched {
+/**
+ * Bounded work-stealing deque by Chase & Lev (with the C11 memory orderings by
+ * Lê et al.).
+ *
+ * The owning thread pushes and pops at the bottom (LIFO), all other threads
+ * steal from the top (FIFO). The buffer is never resized, a full deque rejects
+ * the push instead, so callers can overflow into a shared queue.
+ */
+template <typename T>
+class chase_lev_deque {
+public:
+  using pointer = T*;
+
+  /** constructor */
+  explicit chase_lev_deque(std::size_t capacity) :
+    m_slots{ std::make_unique<std::atomic<pointer>[]>(capacity) },
+    m_mask{ static_cast<std::int64_t>(capacity - 1) }
+  {
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+      throw std::invalid_argument("deque capacity must be a power of two");
+    }
+  }
+
+  /** must only be called by the owner, fails if the deque is full */
+  bool push(pointer elem) noexcept {
+    const auto bottom = this->m_bottom.load(relaxed);
+    const auto top = this->m_top.load(acquire);
+    if (bottom - top > this->m_mask) {
+      return false;
+    }
+
+    this->m_slots[bottom & this->m_mask].store(elem, relaxed);
+    std::atomic_thread_fence(release);
+    this->m_bottom.store(bottom + 1, relaxed);
+    return true;
+  }
+
+  /** must only be called by the owner, returns nullptr if the deque is empty */
+  pointer pop() noexcept {
+    const auto bottom = this->m_bottom.load(relaxed) - 1;
+    this->m_bottom.store(bottom, relaxed);
+    std::atomic_thread_fence(seq_cst);
+    auto top = this->m_top.load(relaxed);
+
+    if (top > bottom) {
+      this->m_bottom.store(bottom + 1, relaxed);
+      return nullptr;
+    }
+
+    auto res = this->m_slots[bottom & this->m_mask].load(relaxed);
+    if (top == bottom) {
+      // the last element may be stolen concurrently
+      if (!this->m_top.compare_exchange_strong(top, top + 1, seq_cst, relaxed)) {
+        res = nullptr;
+      }
+
+      this->m_bottom.store(bottom + 1, relaxed);
+    }
+
+    return res;
+  }
+
+  /** may be called by any thread, returns nullptr if the deque is empty or the
+   *  steal lost a race */
+  pointer steal() noexcept {
+    auto top = this->m_top.load(acquire);
+    std::atomic_thread_fence(seq_cst);
+    const auto bottom = this->m_bottom.load(acquire);
+    if (top >= bottom) {
+      return nullptr;
+    }
+
+    const auto res = this->m_slots[top & this->m_mask].load(relaxed);
+    if (!this->m_top.compare_exchange_strong(top, top + 1, seq_cst, relaxed)) {
+      return nullptr;
+    }
+
+    return res;
+  }
+
+  chase_lev_deque(const chase_lev_deque&)            = delete;
+  chase_lev_deque(chase_lev_deque&&)                 = delete;
+  chase_lev_deque& operator=(const chase_lev_deque&) = delete;
+  chase_lev_deque& operator=(chase_lev_deque&&)      = delete;
+
+private:
+  /** ordering constants */
+  static constexpr auto relaxed = std::memory_order_relaxed;
+  static constexpr auto acquire = std::memory_order_acquire;
+  static constexpr auto release = std::memory_order_release;
+  static constexpr auto seq_cst = std::memory_order_seq_cst;
+
+  alignas(CACHE_LINE_ALIGN) std::atomic<std::int64_t> m_top{ 0 };
+  alignas(CACHE_LINE_ALIGN) std::atomic<std::int64_t> m_bottom{ 0 };
+  /** read-only after construction */
+  alignas(CACHE_LINE_ALIGN) std::unique_ptr<std::atomic<pointer>[]> m_slots;
+  const std::int64_t                                               m_mask;
+};
+}
+
+#endif /* LOO_QUEUE_BENCHMARK_CHASE_LEV_HPP */
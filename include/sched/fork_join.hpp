@@ -0,0 +1,375 @@
+#ifndef LOO_QUEUE_BENCHMARK_FORK_JOIN_HPP
+#define LOO_QUEUE_BENCHMARK_FORK_JOIN_HPP
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include "looqueue/align.hpp"
+#include "sched/chase_lev.hpp"
+
+namespace sched {
+/** the recursive problems solved by the scheduler's jobs */
+enum class workload_t { FIB, NQUEENS, TREE };
+/** all jobs through the injection queue or per-worker deques with stealing */
+enum class mode_t { SHARED, STEALING };
+
+/** problem sizes and sequential cutoffs of the workloads */
+constexpr std::uint32_t FIB_N          = 30;
+constexpr std::uint32_t FIB_CUTOFF     = 10;
+constexpr std::uint32_t NQUEENS_N      = 12;
+constexpr std::uint32_t NQUEENS_CUTOFF = 4;
+constexpr std::uint32_t TREE_DEPTH     = 20;
+constexpr std::uint32_t TREE_CUTOFF    = 13;
+constexpr std::uint64_t TREE_SEED      = 0x2545f4914f6cdd1d;
+
+inline std::string_view display_str(workload_t workload) {
+  switch (workload) {
+    case workload_t::FIB:     return "fib";
+    case workload_t::NQUEENS: return "nqueens";
+    case workload_t::TREE:    return "tree";
+  }
+
+  throw std::invalid_argument("unknown workload");
+}
+
+inline std::string_view display_str(mode_t mode) {
+  return mode == mode_t::SHARED ? "shared" : "stealing";
+}
+
+/**
+ * One (sub-)problem of a workload.
+ *
+ * Jobs above the cutoff spawn their children and complete only once the last
+ * child has completed (i.e., joins are continuations, no worker ever blocks),
+ * so each child adds its result to its parent before dropping its reference.
+ */
+struct job_t {
+  workload_t                 workload;
+  /** fib: n, nqueens: row, tree: depth */
+  std::uint32_t              level;
+  /** nqueens: occupied columns and diagonals, tree: node seed */
+  std::uint64_t              args[3];
+  job_t*                     parent;
+  std::atomic<std::uint32_t> pending{ 0 };
+  std::atomic<std::uint64_t> result{ 0 };
+
+  job_t(workload_t workload, std::uint32_t level, job_t* parent) :
+    workload{ workload }, level{ level }, args{ 0, 0, 0 }, parent{ parent } {}
+};
+
+/********** sequential workloads **********************************************/
+
+namespace detail {
+inline std::uint64_t mix(std::uint64_t seed) noexcept {
+  seed += 0x9e3779b97f4a7c15;
+  seed = (seed ^ (seed >> 30)) * 0xbf58476d1ce4e5b9;
+  seed = (seed ^ (seed >> 27)) * 0x94d049bb133111eb;
+  return seed ^ (seed >> 31);
+}
+
+/** value of a tree node */
+inline std::uint64_t tree_value(std::uint64_t seed) noexcept {
+  return seed & 0xff;
+}
+
+/** number of children (1 to 3) of an inner tree node, so that subtrees of the
+ *  same depth differ greatly in size */
+inline std::uint32_t tree_children(std::uint32_t depth, std::uint64_t seed) noexcept {
+  return depth == TREE_DEPTH ? 0 : 1 + static_cast<std::uint32_t>((seed >> 8) % 3);
+}
+
+inline std::uint64_t tree_child_seed(std::uint64_t seed, std::uint32_t child) noexcept {
+  return mix(seed + child + 1);
+}
+
+inline std::uint64_t fib(std::uint32_t n) noexcept {
+  return n < 2 ? n : fib(n - 1) + fib(n - 2);
+}
+
+inline std::uint64_t nqueens(
+    std::uint32_t row,
+    std::uint64_t cols,
+    std::uint64_t left,
+    std::uint64_t right
+) noexcept {
+  if (row == NQUEENS_N) {
+    return 1;
+  }
+
+  const std::uint64_t all = (std::uint64_t{ 1 } << NQUEENS_N) - 1;
+  std::uint64_t res = 0;
+  auto free = ~(cols | left | right) & all;
+  while (free != 0) {
+    const auto bit = free & -free;
+    free ^= bit;
+    res += nqueens(row + 1, cols | bit, ((left | bit) << 1) & all, (right | bit) >> 1);
+  }
+
+  return res;
+}
+
+inline std::uint64_t tree_sum(std::uint32_t depth, std::uint64_t seed) noexcept {
+  auto res = tree_value(seed);
+  const auto children = tree_children(depth, seed);
+  for (std::uint32_t child = 0; child < children; ++child) {
+    res += tree_sum(depth + 1, tree_child_seed(seed, child));
+  }
+
+  return res;
+}
+}
+
+/** returns the job for the entire problem of the given workload */
+inline job_t* make_root_job(workload_t workload) {
+  auto root = new job_t{ workload, 0, nullptr };
+  if (workload == workload_t::FIB) {
+    root->level = FIB_N;
+  } else if (workload == workload_t::TREE) {
+    root->args[0] = TREE_SEED;
+  }
+
+  return root;
+}
+
+/** solves the entire problem of the given workload sequentially */
+inline std::uint64_t expected_result(workload_t workload) {
+  switch (workload) {
+    case workload_t::FIB:     return detail::fib(FIB_N);
+    case workload_t::NQUEENS: return detail::nqueens(0, 0, 0, 0);
+    case workload_t::TREE:    return detail::tree_sum(0, TREE_SEED);
+  }
+
+  throw std::invalid_argument("unknown workload");
+}
+
+/********** scheduler *********************************************************/
+
+/**
+ * Fork-join scheduler, which uses an arbitrary queue as its global injection
+ * queue.
+ *
+ * In `SHARED` mode, every spawned job passes through the injection queue. In
+ * `STEALING` mode, each worker pushes its spawned jobs to its own Chase-Lev
+ * deque and only falls back to the injection queue when its deque is full
+ * (overflow) or empty (polling), before trying to steal from a random victim.
+ *
+ * The injection queue is accessed through the worker's queue reference, whose
+ * element type only serves as opaque pointer for the jobs.
+ */
+class fork_join_pool {
+public:
+  /** the capacity of each worker's deque */
+  static constexpr std::size_t DEQUE_CAPACITY = 4096;
+
+  /** per-worker counters, valid once all workers have returned */
+  struct stats_t {
+    std::size_t executed{ 0 };
+    std::size_t steals{ 0 };
+    std::size_t overflows{ 0 };
+  };
+
+  /** constructor */
+  fork_join_pool(std::size_t threads, mode_t mode) : m_mode{ mode } {
+    this->m_workers.reserve(threads);
+    for (std::size_t thread = 0; thread < threads; ++thread) {
+      this->m_workers.push_back(std::make_unique<worker_t>());
+    }
+  }
+
+  /** enqueues the root job, must be called before any worker is started */
+  template <typename R>
+  void inject(R& injector, job_t* root) {
+    using pointer = decltype(injector.dequeue());
+    injector.enqueue(reinterpret_cast<pointer>(root));
+  }
+
+  /** runs jobs on the calling thread until the root job has completed */
+  template <typename R>
+  void work(R& injector, std::size_t thread_id) {
+    this->work(injector, thread_id, [] {});
+  }
+
+  /** runs jobs on the calling thread until the root job has completed and
+   *  calls `after_job` after each executed job */
+  template <typename R, typename F>
+  void work(R& injector, std::size_t thread_id, F&& after_job) {
+    using pointer = decltype(injector.dequeue());
+    auto& worker = *this->m_workers[thread_id];
+    auto rng = detail::mix(thread_id);
+
+    const auto push = [&](job_t* job) {
+      if (this->m_mode == mode_t::STEALING) {
+        if (worker.deque.push(job)) {
+          return;
+        }
+
+        worker.stats.overflows += 1;
+      }
+
+      injector.enqueue(reinterpret_cast<pointer>(job));
+    };
+
+    const auto next_job = [&]() -> job_t* {
+      if (this->m_mode == mode_t::STEALING) {
+        if (const auto job = worker.deque.pop(); job != nullptr) {
+          return job;
+        }
+      }
+
+      if (const auto job = reinterpret_cast<job_t*>(injector.dequeue()); job != nullptr) {
+        return job;
+      }
+
+      if (this->m_mode == mode_t::STEALING && this->m_workers.size() > 1) {
+        rng = detail::mix(rng);
+        auto victim = rng % (this->m_workers.size() - 1);
+        victim += victim >= thread_id ? 1 : 0;
+        if (const auto job = this->m_workers[victim]->deque.steal(); job != nullptr) {
+          worker.stats.steals += 1;
+          return job;
+        }
+      }
+
+      return nullptr;
+    };
+
+    while (!this->m_done.load(std::memory_order_acquire)) {
+      if (const auto job = next_job(); job != nullptr) {
+        this->execute(job, push);
+        worker.stats.executed += 1;
+        after_job();
+      }
+    }
+  }
+
+  /** returns the result of the root job, once it has completed */
+  [[nodiscard]] std::uint64_t result() const noexcept {
+    return this->m_result.load(std::memory_order_acquire);
+  }
+
+  /** returns the sum of all workers' counters */
+  [[nodiscard]] stats_t stats() const noexcept {
+    stats_t res{};
+    for (const auto& worker : this->m_workers) {
+      res.executed += worker->stats.executed;
+      res.steals += worker->stats.steals;
+      res.overflows += worker->stats.overflows;
+    }
+
+    return res;
+  }
+
+  fork_join_pool(const fork_join_pool&)            = delete;
+  fork_join_pool(fork_join_pool&&)                 = delete;
+  fork_join_pool& operator=(const fork_join_pool&) = delete;
+  fork_join_pool& operator=(fork_join_pool&&)      = delete;
+
+private:
+  struct worker_t {
+    chase_lev_deque<job_t> deque{ DEQUE_CAPACITY };
+    alignas(CACHE_LINE_ALIGN) stats_t stats{ };
+  };
+
+  /** either solves the job sequentially or spawns its children */
+  template <typename F>
+  void execute(job_t* job, F& push) {
+    // the join count must be set before the first child can complete
+    const auto fork = [&](std::uint32_t children) {
+      job->pending.store(children, std::memory_order_relaxed);
+    };
+
+    switch (job->workload) {
+      case workload_t::FIB:
+        if (job->level <= FIB_CUTOFF) {
+          this->complete(job, detail::fib(job->level));
+          return;
+        }
+
+        fork(2);
+        push(new job_t{ workload_t::FIB, job->level - 1, job });
+        push(new job_t{ workload_t::FIB, job->level - 2, job });
+        return;
+      case workload_t::NQUEENS: {
+        const auto [cols, left, right] = job->args;
+        if (job->level >= NQUEENS_CUTOFF) {
+          this->complete(job, detail::nqueens(job->level, cols, left, right));
+          return;
+        }
+
+        const std::uint64_t all = (std::uint64_t{ 1 } << NQUEENS_N) - 1;
+        auto free = ~(cols | left | right) & all;
+        if (free == 0) {
+          this->complete(job, 0);
+          return;
+        }
+
+        fork(static_cast<std::uint32_t>(std::popcount(free)));
+        while (free != 0) {
+          const auto bit = free & -free;
+          free ^= bit;
+
+          const auto child = new job_t{ workload_t::NQUEENS, job->level + 1, job };
+          child->args[0] = cols | bit;
+          child->args[1] = ((left | bit) << 1) & all;
+          child->args[2] = (right | bit) >> 1;
+          push(child);
+        }
+        return;
+      }
+      case workload_t::TREE: {
+        const auto seed = job->args[0];
+        if (job->level >= TREE_CUTOFF) {
+          this->complete(job, detail::tree_sum(job->level, seed));
+          return;
+        }
+
+        // inner nodes always have children below the cutoff depth
+        job->result.store(detail::tree_value(seed), std::memory_order_relaxed);
+        const auto children = detail::tree_children(job->level, seed);
+        fork(children);
+        for (std::uint32_t idx = 0; idx < children; ++idx) {
+          const auto child = new job_t{ workload_t::TREE, job->level + 1, job };
+          child->args[0] = detail::tree_child_seed(seed, idx);
+          push(child);
+        }
+        return;
+      }
+    }
+  }
+
+  /** propagates the result of a completed job up to all ancestors that have
+   *  been completed by it */
+  void complete(job_t* job, std::uint64_t result) {
+    while (true) {
+      const auto parent = job->parent;
+      delete job;
+
+      if (parent == nullptr) {
+        this->m_result.store(result, std::memory_order_release);
+        this->m_done.store(true, std::memory_order_release);
+        return;
+      }
+
+      parent->result.fetch_add(result, std::memory_order_relaxed);
+      if (parent->pending.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+      }
+
+      job = parent;
+      result = parent->result.load(std::memory_order_relaxed);
+    }
+  }
+
+  const mode_t                                       m_mode;
+  std::vector<std::unique_ptr<worker_t>>             m_workers{ };
+  alignas(CACHE_LINE_ALIGN) std::atomic<bool>        m_done{ false };
+  std::atomic<std::uint64_t>                         m_result{ 0 };
+};
+}
+
+#endif /* LOO_QUEUE_BENCHMARK_FORK_JOIN_HPP */
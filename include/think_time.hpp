@@ -0,0 +1,74 @@
+#ifndef LOO_QUEUE_BENCHES_THINK_TIME_HPP
+#define LOO_QUEUE_BENCHES_THINK_TIME_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+
+#include "common.hpp"
+
+namespace bench {
+/**
+ * The think time of one thread, i.e., the time it spends (spinning) after each
+ * of its operations as if doing actual work, which is drawn from the `--think`
+ * distribution.
+ *
+ * Each thread draws from a PRNG of its own, which is seeded with the thread's
+ * id, so the sequence of think times differs between threads but is the same
+ * in every run.
+ */
+class think_time {
+public:
+  /** constructor */
+  think_time(const think_time_t& think, std::size_t thread) :
+    m_think{ think },
+    m_rng{ make_rng(thread) },
+    m_uniform{ think.first_ns, std::max(think.first_ns, think.second_ns) },
+    m_percent{ 0, 99 }
+  {}
+
+  /** spins for the next think time, returns at once if none is set */
+  void pause() {
+    if (this->m_think.dist != think_dist_t::NONE) {
+      spin_for_ns(this->next_ns());
+    }
+  }
+
+  /** returns the next think time in nanoseconds */
+  [[nodiscard]] std::size_t next_ns() {
+    switch (this->m_think.dist) {
+      case think_dist_t::FIXED:
+        return this->m_think.first_ns;
+      case think_dist_t::UNIFORM:
+        return this->m_uniform(this->m_rng);
+      case think_dist_t::EXPONENTIAL:
+        return static_cast<std::size_t>(
+            this->m_exponential(this->m_rng) * static_cast<double>(this->m_think.first_ns)
+        );
+      case think_dist_t::BIMODAL:
+        return this->m_percent(this->m_rng) < this->m_think.long_percent
+            ? this->m_think.second_ns
+            : this->m_think.first_ns;
+      default:
+        return 0;
+    }
+  }
+
+private:
+  /** seeds the PRNG independently of the ones drawing the operations of the
+   *  reads, writes and mixed benches, which are seeded with the thread id */
+  static std::minstd_rand make_rng(std::size_t thread) {
+    std::seed_seq seed{ std::uint32_t{ 0x7468696e }, static_cast<std::uint32_t>(thread) };
+    return std::minstd_rand{ seed };
+  }
+
+  const think_time_t                         m_think;
+  std::minstd_rand                           m_rng;
+  std::uniform_int_distribution<std::size_t> m_uniform;
+  std::uniform_int_distribution<std::size_t> m_percent;
+  /** unit mean, scaled by the mean think time */
+  std::exponential_distribution<double>      m_exponential{ 1.0 };
+};
+}
+
+#endif /* LOO_QUEUE_BENCHES_THINK_TIME_HPP */
@@ -0,0 +1,178 @@
+#ifndef LOO_QUEUE_BENCHES_TOPOLOGY_HPP
+#define LOO_QUEUE_BENCHES_TOPOLOGY_HPP
+
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace topology {
+/** parses a sysfs CPU list string (e.g. "0-23,48-71") */
+inline std::vector<std::size_t> parse_cpu_list(std::string_view list) {
+  std::vector<std::size_t> res{};
+  while (!list.empty()) {
+    const auto comma = list.find(',');
+    auto range = list.substr(0, comma);
+    list = comma == std::string_view::npos ? std::string_view{} : list.substr(comma + 1);
+
+    std::size_t first = 0, last = 0;
+    const auto dash = range.find('-');
+    const auto first_str = range.substr(0, dash);
+    if (std::from_chars(first_str.begin(), first_str.end(), first).ec != std::errc()) {
+      continue;
+    }
+
+    last = first;
+    if (dash != std::string_view::npos) {
+      const auto last_str = range.substr(dash + 1);
+      if (std::from_chars(last_str.begin(), last_str.end(), last).ec != std::errc()) {
+        continue;
+      }
+    }
+
+    for (auto cpu = first; cpu <= last; ++cpu) {
+      res.push_back(cpu);
+    }
+  }
+
+  return res;
+}
+
+/** one online (logical) CPU and the physical core and package it belongs to */
+struct cpu_t {
+  std::size_t id;
+  std::size_t package;
+  /** the core id, which is only unique within its package */
+  std::size_t core;
+};
+
+/** returns all online CPUs in ascending order, each CPU is assumed to be its
+ *  own core in package 0 if sysfs does not expose the CPU topology */
+inline std::vector<cpu_t> read_cpus() {
+  const std::filesystem::path sysfs_cpus{ "/sys/devices/system/cpu" };
+
+  const auto read_size = [](const std::filesystem::path& path, std::size_t fallback) {
+    std::ifstream file{ path };
+    std::string str;
+    std::size_t res;
+    if (!std::getline(file, str) || std::from_chars(str.data(), str.data() + str.size(), res).ec != std::errc()) {
+      return fallback;
+    }
+
+    return res;
+  };
+
+  std::vector<std::size_t> ids{};
+  std::ifstream online{ sysfs_cpus / "online" };
+  if (std::string list; std::getline(online, list)) {
+    ids = parse_cpu_list(list);
+  }
+
+  if (ids.empty()) {
+    ids.resize(std::max(std::thread::hardware_concurrency(), 1u));
+    for (std::size_t cpu = 0; cpu < ids.size(); ++cpu) {
+      ids[cpu] = cpu;
+    }
+  }
+
+  std::vector<cpu_t> res{};
+  res.reserve(ids.size());
+  for (const auto id : ids) {
+    const auto topology = sysfs_cpus / ("cpu" + std::to_string(id)) / "topology";
+    res.push_back({
+        id,
+        read_size(topology / "physical_package_id", 0),
+        read_size(topology / "core_id", id)
+    });
+  }
+
+  return res;
+}
+
+/** returns the number of distinct physical cores of the given CPUs */
+inline std::size_t count_cores(std::vector<cpu_t> cpus) {
+  std::sort(cpus.begin(), cpus.end(), [](const auto& lhs, const auto& rhs) {
+    return std::tie(lhs.package, lhs.core) < std::tie(rhs.package, rhs.core);
+  });
+
+  const auto end = std::unique(cpus.begin(), cpus.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.package == rhs.package && lhs.core == rhs.core;
+  });
+
+  return static_cast<std::size_t>(end - cpus.begin());
+}
+
+namespace detail {
+/** the CPU of each thread id, empty if thread `i` runs on CPU `i` */
+inline std::vector<std::size_t> thread_cpus{};
+}
+
+/** sets the CPU each thread id is pinned to, must be called before any thread
+ *  is started */
+inline void set_thread_cpus(std::vector<std::size_t> cpus) {
+  detail::thread_cpus = std::move(cpus);
+}
+
+/** returns the CPU the thread with the given id is pinned to, the CPUs are
+ *  reused in the same order for thread ids beyond the number of CPUs */
+inline std::size_t cpu_of_thread(std::size_t thread_id) {
+  const auto& cpus = detail::thread_cpus;
+  return cpus.empty() ? thread_id : cpus[thread_id % cpus.size()];
+}
+
+/** returns the NUMA node of every CPU indexed by CPU number, all CPUs are
+ *  assigned to node 0 if sysfs does not expose the NUMA topology */
+inline std::vector<std::size_t> cpu_numa_nodes() {
+  const std::filesystem::path sysfs_nodes{ "/sys/devices/system/node" };
+  std::vector<std::size_t> res(std::max(std::thread::hardware_concurrency(), 1u), 0);
+
+  std::error_code err;
+  for (const auto& entry : std::filesystem::directory_iterator(sysfs_nodes, err)) {
+    const auto name = entry.path().filename().string();
+    std::size_t node;
+    if (
+        !name.starts_with("node")
+        || std::from_chars(name.data() + 4, name.data() + name.size(), node).ec != std::errc()
+    ) {
+      continue;
+    }
+
+    std::ifstream file{ entry.path() / "cpulist" };
+    std::string list;
+    if (!std::getline(file, list)) {
+      continue;
+    }
+
+    for (const auto cpu : parse_cpu_list(list)) {
+      if (cpu >= res.size()) {
+        res.resize(cpu + 1, 0);
+      }
+
+      res[cpu] = node;
+    }
+  }
+
+  return res;
+}
+
+/** returns the NUMA node of the CPU of each of the first `threads` thread ids
+ *  (cf. `cpu_of_thread`) */
+inline std::vector<std::size_t> thread_numa_nodes(std::size_t threads) {
+  const auto cpu_nodes = cpu_numa_nodes();
+  std::vector<std::size_t> res(threads, 0);
+  for (std::size_t thread = 0; thread < threads; ++thread) {
+    const auto cpu = cpu_of_thread(thread);
+    res[thread] = cpu < cpu_nodes.size() ? cpu_nodes[cpu] : 0;
+  }
+
+  return res;
+}
+}
+
+#endif /* LOO_QUEUE_BENCHES_TOPOLOGY_HPP */
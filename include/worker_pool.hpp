@@ -0,0 +1,196 @@
+#ifndef LOO_QUEUE_BENCHES_WORKER_POOL_HPP
+#define LOO_QUEUE_BENCHES_WORKER_POOL_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <x86intrin.h>
+
+#include "looqueue/align.hpp"
+
+#include "alloc_stats.hpp"
+#include "common.hpp"
+#include "queue_events.hpp"
+
+namespace bench {
+/**
+ * Sense-reversing barrier for a fixed number of threads, which spins instead
+ * of blocking in the kernel, so all threads leave it within a few cache misses
+ * of the last one arriving.
+ *
+ * Waiting threads only fall back to yielding after `SPINS_BEFORE_YIELD`
+ * iterations, so that runs with more threads than CPUs still make progress.
+ */
+class spin_barrier {
+public:
+  static constexpr std::size_t SPINS_BEFORE_YIELD = 1 << 14;
+
+  /** constructor */
+  explicit spin_barrier(std::size_t threads) : m_threads{ threads }, m_remaining{ threads } {
+    if (threads == 0) {
+      throw std::invalid_argument("barrier requires at least one thread");
+    }
+  }
+
+  void wait() noexcept {
+    // the sense can not change before the calling thread has arrived
+    const auto sense = this->m_sense.load(std::memory_order_relaxed);
+    if (this->m_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      this->m_remaining.store(this->m_threads, std::memory_order_relaxed);
+      this->m_sense.store(!sense, std::memory_order_release);
+      return;
+    }
+
+    for (std::size_t spins = 0; this->m_sense.load(std::memory_order_acquire) == sense; ++spins) {
+      if (spins < SPINS_BEFORE_YIELD) {
+        _mm_pause();
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  spin_barrier(const spin_barrier&)            = delete;
+  spin_barrier(spin_barrier&&)                 = delete;
+  spin_barrier& operator=(const spin_barrier&) = delete;
+  spin_barrier& operator=(spin_barrier&&)      = delete;
+
+private:
+  const std::size_t                                m_threads;
+  alignas(CACHE_LINE_ALIGN) std::atomic<std::size_t> m_remaining;
+  alignas(CACHE_LINE_ALIGN) std::atomic<bool>        m_sense{ false };
+};
+
+/**
+ * Persistent worker threads, which are reused by all runs of all benches.
+ *
+ * Each worker is started on first use and pinned (once) to the CPU of its id
+ * (cf. `pin_current_thread`), so its stack and the pages it touches stay warm
+ * across runs. Idle workers block until they are handed a job, since handing
+ * out and joining jobs happens outside of the measured section of each run,
+ * which is delimited by `spin_barrier`s instead.
+ */
+class worker_pool {
+public:
+  worker_pool() = default;
+
+  ~worker_pool() noexcept {
+    for (std::size_t worker_id = 0; worker_id < this->m_workers.size(); ++worker_id) {
+      auto& worker = this->m_workers[worker_id];
+      if (worker == nullptr) {
+        continue;
+      }
+
+      // a pending job must complete before the worker can be stopped
+      this->join(worker_id);
+      worker->state.store(STOP, std::memory_order_release);
+      worker->state.notify_one();
+      worker->thread.join();
+    }
+  }
+
+  /** runs `fn` on the worker with the given id, which must not have an
+   *  unjoined job */
+  template <typename F>
+  void spawn(std::size_t worker_id, F&& fn) {
+    if (worker_id >= this->m_workers.size()) {
+      this->m_workers.resize(worker_id + 1);
+    }
+
+    auto& worker = this->m_workers[worker_id];
+    if (worker == nullptr) {
+      worker = std::make_unique<worker_t>();
+      worker->thread = std::thread([&state = worker->state, &job = worker->job, worker_id] {
+        pin_current_thread(worker_id);
+        work(state, job);
+      });
+    }
+
+    if (worker->state.load(std::memory_order_acquire) != IDLE) {
+      throw std::logic_error("worker must be joined before it is spawned again");
+    }
+
+    worker->job = std::forward<F>(fn);
+    worker->state.store(READY, std::memory_order_release);
+    worker->state.notify_one();
+  }
+
+  /** waits until the worker with the given id has completed its job, does
+   *  nothing if it has none */
+  void join(std::size_t worker_id) {
+    if (worker_id >= this->m_workers.size() || this->m_workers[worker_id] == nullptr) {
+      return;
+    }
+
+    auto& state = this->m_workers[worker_id]->state;
+    for (auto current = state.load(std::memory_order_acquire); current == READY; current = state.load(std::memory_order_acquire)) {
+      state.wait(READY, std::memory_order_acquire);
+    }
+
+    state.store(IDLE, std::memory_order_relaxed);
+  }
+
+  /** waits until all workers have completed their jobs */
+  void join_all() {
+    for (std::size_t worker_id = 0; worker_id < this->m_workers.size(); ++worker_id) {
+      this->join(worker_id);
+    }
+  }
+
+  /** returns the pool shared by all benches */
+  static worker_pool& shared() {
+    static worker_pool pool{};
+    return pool;
+  }
+
+  worker_pool(const worker_pool&)            = delete;
+  worker_pool(worker_pool&&)                 = delete;
+  worker_pool& operator=(const worker_pool&) = delete;
+  worker_pool& operator=(worker_pool&&)      = delete;
+
+private:
+  static constexpr int IDLE  = 0;
+  static constexpr int READY = 1;
+  static constexpr int DONE  = 2;
+  static constexpr int STOP  = 3;
+
+  struct alignas(CACHE_LINE_ALIGN) worker_t {
+    std::thread           thread{ };
+    std::function<void()> job{ };
+    std::atomic<int>      state{ IDLE };
+  };
+
+  static void work(std::atomic<int>& state, std::function<void()>& job) {
+    while (true) {
+      auto current = state.load(std::memory_order_acquire);
+      while (current != READY && current != STOP) {
+        state.wait(current, std::memory_order_acquire);
+        current = state.load(std::memory_order_acquire);
+      }
+
+      if (current == STOP) {
+        return;
+      }
+
+      job();
+      job = nullptr;
+      // the worker does not exit after the run, so its events and allocations
+      // must be added to the totals before the run is joined
+      events::flush_thread();
+      alloc::flush_thread();
+      state.store(DONE, std::memory_order_release);
+      state.notify_one();
+    }
+  }
+
+  std::vector<std::unique_ptr<worker_t>> m_workers{ };
+};
+}
+
+#endif /* LOO_QUEUE_BENCHES_WORKER_POOL_HPP */
@@ -11,4 +11,10 @@ sbatch macro/loo.sh
 sbatch macro/scq2.sh
 sbatch macro/scqd.sh
 sbatch macro/ymc.sh
-
+sbatch macro/fc.sh
+sbatch macro/mtx.sh
+sbatch macro/tlq.sh
+sbatch macro/tkt.sh
+sbatch macro/shd.sh
+sbatch macro/kpq.sh
+sbatch macro/hrq.sh
@@ -11,3 +11,10 @@ sbatch micro/loo.sh
 sbatch micro/scq2.sh
 sbatch micro/scqd.sh
 sbatch micro/ymc.sh
+sbatch micro/fc.sh
+sbatch micro/mtx.sh
+sbatch micro/tlq.sh
+sbatch micro/tkt.sh
+sbatch micro/shd.sh
+sbatch micro/kpq.sh
+sbatch micro/hrq.sh
@@ -0,0 +1,41 @@
+#!/bin/sh
+
+#SBATCH --job-name=numa_micro
+#SBATCH --time 04:00:00
+#SBATCH --nodes=1
+#SBATCH --ntasks=1
+#SBATCH --partition=standard96:test
+#SBATCH -L ansys:1
+
+# compares the flat and NUMA-hierarchical queues with both thread placements
+# from the machine's topology instead of relying on its CPU numbering:
+# 'compact' fills one socket before the next, 'scatter' alternates between
+# sockets from the first thread on
+#
+# note that the queues do not give the same guarantees: faa and loo are
+# linearizable FIFO queues, while hrq is a relaxed queue, which hands off
+# per-node batches to a global queue and only preserves the FIFO order of the
+# elements of each single producer, so its results are not a like-for-like
+# comparison
+size=10M
+iters=100
+
+parent_dir=$HOME/projects/looqueue-benchmarks
+cd $parent_dir/cmake-build-remote-release || exit
+
+echo "note: hrq only guarantees per-producer FIFO order (relaxed, batched per node)," \
+  "faa and loo are linearizable"
+
+for queue in faa loo hrq
+do
+  out_dir=$parent_dir/csv/$queue/$size/numa
+  mkdir -p $out_dir
+  for affinity in compact scatter
+  do
+    for threads in 24 48 64 80 96
+    do
+      ./bench_throughput $queue pairs $size $iters $threads --affinity=$affinity \
+        > $out_dir/pairs_${affinity}_$threads.csv
+    done
+  done
+done
@@ -0,0 +1,305 @@
+#include "alloc_stats.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <new>
+#include <string>
+
+#include <malloc.h>
+
+/********** counters **********************************************************/
+
+namespace {
+/** the sums of the flushed counters of all threads */
+struct totals_t {
+  std::atomic<std::uint64_t> allocs{ 0 };
+  std::atomic<std::uint64_t> frees{ 0 };
+  std::atomic<std::uint64_t> bytes{ 0 };
+  std::atomic<std::int64_t>  live{ 0 };
+  std::atomic<std::int64_t>  peak_live{ 0 };
+  /** the live bytes at the start of the run, only accessed by the main thread */
+  std::int64_t               start_live{ 0 };
+};
+
+constinit totals_t totals{};
+
+/** the counters of one thread, which must remain trivially destructible, since
+ *  registering a thread-local destructor may itself allocate */
+struct thread_counters_t {
+  std::uint64_t allocs;
+  std::uint64_t frees;
+  std::uint64_t bytes;
+  std::int64_t  live;
+  /** set while a hook passes a call on, so allocations made by the allocator
+   *  itself (e.g., `operator new` calling `malloc`) are not counted twice */
+  bool          in_hook;
+};
+
+constinit thread_local thread_counters_t thread_counters{};
+
+void flush(thread_counters_t& counters) noexcept {
+  totals.allocs.fetch_add(counters.allocs, std::memory_order_relaxed);
+  totals.frees.fetch_add(counters.frees, std::memory_order_relaxed);
+  totals.bytes.fetch_add(counters.bytes, std::memory_order_relaxed);
+
+  const auto live = totals.live.fetch_add(counters.live, std::memory_order_relaxed) + counters.live;
+  auto peak = totals.peak_live.load(std::memory_order_relaxed);
+  while (live > peak && !totals.peak_live.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+
+  counters.allocs = counters.frees = counters.bytes = 0;
+  counters.live = 0;
+}
+
+void count_alloc(void* ptr) noexcept {
+  auto& counters = thread_counters;
+  if (ptr == nullptr || counters.in_hook) {
+    return;
+  }
+
+  const auto size = ::malloc_usable_size(ptr);
+  counters.allocs += 1;
+  counters.bytes += size;
+  counters.live += static_cast<std::int64_t>(size);
+  if (counters.live >= alloc::FLUSH_BYTES) {
+    flush(counters);
+  }
+}
+
+/** counts the free of an allocation with the given usable size */
+void count_free_size(std::size_t size) noexcept {
+  auto& counters = thread_counters;
+  counters.frees += 1;
+  counters.live -= static_cast<std::int64_t>(size);
+  if (counters.live <= -alloc::FLUSH_BYTES) {
+    flush(counters);
+  }
+}
+
+void count_free(void* ptr) noexcept {
+  if (ptr == nullptr || thread_counters.in_hook) {
+    return;
+  }
+
+  count_free_size(::malloc_usable_size(ptr));
+}
+
+/** passes a call on to the wrapped function without counting nested calls */
+template <typename F>
+auto pass_on(F&& fn) noexcept(noexcept(fn())) {
+  auto& counters = thread_counters;
+  const auto nested = counters.in_hook;
+  counters.in_hook = true;
+  struct restore_t {
+    thread_counters_t& counters;
+    bool               nested;
+    ~restore_t() { counters.in_hook = this->nested; }
+  } restore{ counters, nested };
+
+  return fn();
+}
+
+/** returns the process' peak RSS (in KiB) as reported by the kernel */
+std::size_t read_peak_rss() {
+  std::ifstream file{ "/proc/self/status" };
+  std::string line{};
+  while (std::getline(file, line)) {
+    if (line.starts_with("VmHWM:")) {
+      return std::stoul(line.substr(6));
+    }
+  }
+
+  return 0;
+}
+}
+
+/********** wrapped allocation functions **************************************/
+
+// the functions are defined by the allocator (or the C and C++ standard
+// libraries) and renamed to `__real_<name>` by `--wrap=<name>`, all calls to
+// `<name>` from the bench itself or the statically linked libraries are
+// renamed to `__wrap_<name>`
+extern "C" {
+void* __real_malloc(std::size_t size);
+void* __real_calloc(std::size_t count, std::size_t size);
+void* __real_realloc(void* ptr, std::size_t size);
+void* __real_aligned_alloc(std::size_t align, std::size_t size);
+int   __real_posix_memalign(void** ptr, std::size_t align, std::size_t size);
+void  __real_free(void* ptr);
+
+// operator new(std::size_t), new[](std::size_t) and their aligned versions
+void* __real__Znwm(std::size_t size);
+void* __real__Znam(std::size_t size);
+void* __real__ZnwmSt11align_val_t(std::size_t size, std::align_val_t align);
+void* __real__ZnamSt11align_val_t(std::size_t size, std::align_val_t align);
+// operator delete(void*), delete[](void*) and their sized and aligned versions
+void  __real__ZdlPv(void* ptr);
+void  __real__ZdaPv(void* ptr);
+void  __real__ZdlPvm(void* ptr, std::size_t size);
+void  __real__ZdaPvm(void* ptr, std::size_t size);
+void  __real__ZdlPvSt11align_val_t(void* ptr, std::align_val_t align);
+void  __real__ZdaPvSt11align_val_t(void* ptr, std::align_val_t align);
+void  __real__ZdlPvmSt11align_val_t(void* ptr, std::size_t size, std::align_val_t align);
+void  __real__ZdaPvmSt11align_val_t(void* ptr, std::size_t size, std::align_val_t align);
+
+void* __wrap_malloc(std::size_t size) {
+  const auto ptr = pass_on([&] { return __real_malloc(size); });
+  count_alloc(ptr);
+  return ptr;
+}
+
+void* __wrap_calloc(std::size_t count, std::size_t size) {
+  const auto ptr = pass_on([&] { return __real_calloc(count, size); });
+  count_alloc(ptr);
+  return ptr;
+}
+
+void* __wrap_realloc(void* ptr, std::size_t size) {
+  // the size of the old allocation must be read before it is passed on, since
+  // it may already be freed afterwards
+  const auto counted = ptr != nullptr && !thread_counters.in_hook;
+  const auto old_size = counted ? ::malloc_usable_size(ptr) : 0;
+  const auto res = pass_on([&] { return __real_realloc(ptr, size); });
+
+  // a failed realloc leaves the old allocation untouched, except for a size
+  // of zero, for which the old allocation is always freed and the result (if
+  // any) is a new minimal allocation
+  if (res == nullptr && size != 0) {
+    return res;
+  }
+
+  if (counted) {
+    count_free_size(old_size);
+  }
+
+  count_alloc(res);
+  return res;
+}
+
+void* __wrap_aligned_alloc(std::size_t align, std::size_t size) {
+  const auto ptr = pass_on([&] { return __real_aligned_alloc(align, size); });
+  count_alloc(ptr);
+  return ptr;
+}
+
+int __wrap_posix_memalign(void** ptr, std::size_t align, std::size_t size) {
+  const auto res = pass_on([&] { return __real_posix_memalign(ptr, align, size); });
+  if (res == 0) {
+    count_alloc(*ptr);
+  }
+
+  return res;
+}
+
+void __wrap_free(void* ptr) {
+  count_free(ptr);
+  pass_on([&] { __real_free(ptr); });
+}
+
+void* __wrap__Znwm(std::size_t size) {
+  const auto ptr = pass_on([&] { return __real__Znwm(size); });
+  count_alloc(ptr);
+  return ptr;
+}
+
+void* __wrap__Znam(std::size_t size) {
+  const auto ptr = pass_on([&] { return __real__Znam(size); });
+  count_alloc(ptr);
+  return ptr;
+}
+
+void* __wrap__ZnwmSt11align_val_t(std::size_t size, std::align_val_t align) {
+  const auto ptr = pass_on([&] { return __real__ZnwmSt11align_val_t(size, align); });
+  count_alloc(ptr);
+  return ptr;
+}
+
+void* __wrap__ZnamSt11align_val_t(std::size_t size, std::align_val_t align) {
+  const auto ptr = pass_on([&] { return __real__ZnamSt11align_val_t(size, align); });
+  count_alloc(ptr);
+  return ptr;
+}
+
+void __wrap__ZdlPv(void* ptr) {
+  count_free(ptr);
+  pass_on([&] { __real__ZdlPv(ptr); });
+}
+
+void __wrap__ZdaPv(void* ptr) {
+  count_free(ptr);
+  pass_on([&] { __real__ZdaPv(ptr); });
+}
+
+void __wrap__ZdlPvm(void* ptr, std::size_t size) {
+  count_free(ptr);
+  pass_on([&] { __real__ZdlPvm(ptr, size); });
+}
+
+void __wrap__ZdaPvm(void* ptr, std::size_t size) {
+  count_free(ptr);
+  pass_on([&] { __real__ZdaPvm(ptr, size); });
+}
+
+void __wrap__ZdlPvSt11align_val_t(void* ptr, std::align_val_t align) {
+  count_free(ptr);
+  pass_on([&] { __real__ZdlPvSt11align_val_t(ptr, align); });
+}
+
+void __wrap__ZdaPvSt11align_val_t(void* ptr, std::align_val_t align) {
+  count_free(ptr);
+  pass_on([&] { __real__ZdaPvSt11align_val_t(ptr, align); });
+}
+
+void __wrap__ZdlPvmSt11align_val_t(void* ptr, std::size_t size, std::align_val_t align) {
+  count_free(ptr);
+  pass_on([&] { __real__ZdlPvmSt11align_val_t(ptr, size, align); });
+}
+
+void __wrap__ZdaPvmSt11align_val_t(void* ptr, std::size_t size, std::align_val_t align) {
+  count_free(ptr);
+  pass_on([&] { __real__ZdaPvmSt11align_val_t(ptr, size, align); });
+}
+}
+
+/********** alloc *************************************************************/
+
+namespace alloc {
+void begin_run() {
+  flush_thread();
+  totals.allocs.store(0, std::memory_order_relaxed);
+  totals.frees.store(0, std::memory_order_relaxed);
+  totals.bytes.store(0, std::memory_order_relaxed);
+  totals.start_live = totals.live.load(std::memory_order_relaxed);
+  totals.peak_live.store(totals.start_live, std::memory_order_relaxed);
+
+  // resets the peak RSS to the current RSS (Linux 4.0+), if this fails, the
+  // peak RSS covers the entire process instead of only the run
+  std::ofstream clear_refs{ "/proc/self/clear_refs" };
+  clear_refs << "5";
+}
+
+void flush_thread() noexcept {
+  flush(thread_counters);
+}
+
+void print_totals(std::ostream& os, std::size_t total_ops) {
+  flush_thread();
+
+  // the totals are read before printing, which may itself allocate
+  const auto allocs = totals.allocs.load(std::memory_order_relaxed);
+  const auto frees = totals.frees.load(std::memory_order_relaxed);
+  const auto bytes = totals.bytes.load(std::memory_order_relaxed);
+  const auto peak_live = totals.peak_live.load(std::memory_order_relaxed) - totals.start_live;
+  const auto peak_rss = read_peak_rss();
+
+  os
+      << "," << allocs
+      << "," << frees
+      << "," << bytes
+      << "," << peak_live
+      << "," << peak_rss
+      << "," << static_cast<double>(bytes) / static_cast<double>(std::max<std::size_t>(total_ops, 1));
+}
+}
@@ -0,0 +1,306 @@
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "common.hpp"
+#include "queues/shm/shm_faa_array.hpp"
+
+/********** constants *********************************************************/
+
+/** the number of bits for the per-producer sequence number in each value */
+constexpr std::uint64_t SEQ_BITS = 40;
+/** the number of spins after which the parent checks for exited children */
+constexpr std::size_t POLL_INTERVAL = 1 << 16;
+
+/********** types *************************************************************/
+
+/** state shared between all benchmark processes in an anonymous mapping */
+struct sync_t {
+  std::atomic<std::size_t> ready{ 0 };
+  std::atomic<bool>        start{ false };
+  /** the number of children, which have completed all their operations */
+  std::atomic<std::size_t> done{ 0 };
+};
+
+/********** functions *********************************************************/
+
+/** parses the optional process count argument at `idx` */
+std::size_t parse_process_count(int argc, char* argv[], int idx) {
+  if (argc <= idx) {
+    return 1;
+  }
+
+  const std::string_view str{ argv[idx] };
+  std::size_t res;
+  const auto err = std::from_chars(str.begin(), str.end(), res);
+  if (err.ec != std::errc() || res == 0) {
+    throw std::invalid_argument("producer/consumer count: expected positive integer");
+  }
+
+  return res;
+}
+
+/** waits until the parent process starts the benchmark */
+void await_start(sync_t& sync) {
+  sync.ready.fetch_add(1, std::memory_order_release);
+  while (!sync.start.load(std::memory_order_acquire)) {}
+}
+
+/** enqueues `enqueues` values tagged with the producer's id */
+void run_producer(
+    const std::string& name,
+    sync_t&            sync,
+    std::size_t        producer,
+    std::size_t        enqueues
+) {
+  shm::queue queue{ name };
+  await_start(sync);
+
+  const auto tag = static_cast<std::uint64_t>(producer + 1) << SEQ_BITS;
+  for (std::uint64_t seq = 1; seq <= enqueues; ++seq) {
+    queue.enqueue(tag | seq);
+  }
+
+  sync.done.fetch_add(1, std::memory_order_release);
+}
+
+/** dequeues `dequeues` values, checks per-producer FIFO order and returns
+ *  false, if any value is out of order or invalid */
+bool run_consumer(
+    const std::string& name,
+    sync_t&            sync,
+    std::size_t        producers,
+    std::size_t        dequeues
+) {
+  shm::queue queue{ name };
+  std::vector<std::uint64_t> last_seqs(producers, 0);
+  await_start(sync);
+
+  for (std::size_t op = 0; op < dequeues; ++op) {
+    std::uint64_t value;
+    while ((value = queue.dequeue()) == 0) {}
+
+    const auto producer = (value >> SEQ_BITS) - 1;
+    const auto seq = value & ((std::uint64_t{ 1 } << SEQ_BITS) - 1);
+    if (producer >= producers || seq <= last_seqs[producer]) {
+      return false;
+    }
+
+    last_seqs[producer] = seq;
+  }
+
+  sync.done.fetch_add(1, std::memory_order_release);
+  return true;
+}
+
+/** forks a child process, which runs `fn` and exits with its result */
+template <typename F>
+pid_t fork_child(std::size_t cpu, F&& fn) {
+  const auto pid = ::fork();
+  if (pid == -1) {
+    throw std::system_error(errno, std::generic_category(), "failed to fork process");
+  }
+
+  if (pid == 0) {
+    try {
+      bench::pin_current_thread(cpu);
+      ::_exit(fn() ? EXIT_SUCCESS : EXIT_FAILURE);
+    } catch (const std::exception& e) {
+      std::cerr << "child process failed: " << e.what() << std::endl;
+      ::_exit(EXIT_FAILURE);
+    }
+  }
+
+  return pid;
+}
+
+/** reaps all exited children without blocking and removes them from
+ *  `children`, returns false, if any of them has failed */
+bool reap_exited_children(std::vector<pid_t>& children) {
+  auto success = true;
+  std::erase_if(children, [&](pid_t child) {
+    int status;
+    const auto res = ::waitpid(child, &status, WNOHANG);
+    if (res == 0) {
+      return false;
+    }
+
+    if (res == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      success = false;
+    }
+
+    return true;
+  });
+
+  return success;
+}
+
+/** spins until `counter` reaches `target`, returns false as soon as any child
+ *  has failed instead, since the counter would then never reach it */
+bool await_children(
+    const std::atomic<std::size_t>& counter,
+    std::size_t                     target,
+    std::vector<pid_t>&             children
+) {
+  for (std::size_t spins = 1; counter.load(std::memory_order_acquire) < target; ++spins) {
+    if (spins % POLL_INTERVAL == 0 && !reap_exited_children(children)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/** kills and reaps all remaining children */
+void kill_children(std::vector<pid_t>& children) {
+  for (const auto child : children) {
+    ::kill(child, SIGKILL);
+  }
+
+  for (const auto child : children) {
+    ::waitpid(child, nullptr, 0);
+  }
+
+  children.clear();
+}
+
+/** waits until all remaining children have exited, returns false, if any of
+ *  them has failed */
+bool join_children(std::vector<pid_t>& children) {
+  auto success = true;
+  for (const auto child : children) {
+    int status;
+    if (::waitpid(child, &status, 0) == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      success = false;
+    }
+  }
+
+  children.clear();
+  return success;
+}
+
+/** runs the benchmark, in which `producers` and `consumers` processes pass
+ *  (total_ops / 2) elements through a shared memory queue */
+void bench_processes(
+    std::size_t total_ops,
+    std::size_t runs,
+    std::size_t producers,
+    std::size_t consumers
+) {
+  // the parent process is a participant of the queue as well
+  if (producers + consumers >= shm::queue::MAX_PARTICIPANTS) {
+    throw std::invalid_argument(
+        "at most " + std::to_string(shm::queue::MAX_PARTICIPANTS - 1)
+        + " producers and consumers combined are supported"
+    );
+  }
+
+  const auto enqs_per_producer = total_ops / 2 / producers;
+  const auto total_enqueues = enqs_per_producer * producers;
+
+  // each consumer dequeues an equal share, the last one also the remainder
+  const auto deqs_of_consumer = [&](std::size_t consumer) {
+    const auto share = total_enqueues / consumers;
+    return consumer == consumers - 1 ? total_enqueues - share * (consumers - 1) : share;
+  };
+  // the arena must be able to hold all elements, in case the consumers fall
+  // behind, plus the segments abandoned by dequeuers or not yet reclaimed
+  const auto segments = total_enqueues / shm::queue::SEGMENT_SIZE + 64 * (producers + consumers);
+  const auto name = "/lfqueue-bench-ipc-" + std::to_string(::getpid());
+
+  for (auto run = 0; run < runs; ++run) {
+    const auto addr = ::mmap(
+        nullptr, sizeof(sync_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0
+    );
+    if (addr == MAP_FAILED) {
+      throw std::system_error(errno, std::generic_category(), "failed to map shared memory");
+    }
+
+    auto shared = new (addr) sync_t{};
+    // the queue is created (and its name removed) by the parent process, the
+    // children each attach to it at their own address
+    shm::queue queue{ name, segments };
+
+    std::vector<pid_t> children{};
+    children.reserve(producers + consumers);
+    for (std::size_t producer = 0; producer < producers; ++producer) {
+      children.push_back(fork_child(producer, [&] {
+        run_producer(name, *shared, producer, enqs_per_producer);
+        return true;
+      }));
+    }
+
+    for (std::size_t consumer = 0; consumer < consumers; ++consumer) {
+      children.push_back(fork_child(producers + consumer, [&] {
+        return run_consumer(name, *shared, producers, deqs_of_consumer(consumer));
+      }));
+    }
+
+    // a child failing to attach to the queue (or to start at all) would never
+    // become ready
+    const auto total_children = children.size();
+    const auto ready = await_children(shared->ready, total_children, children);
+    shm::queue::unlink(name);
+    if (!ready) {
+      kill_children(children);
+      ::munmap(addr, sizeof(sync_t));
+      throw std::runtime_error("benchmark process failed before the start");
+    }
+
+    // measures total time from the start signal until all children have
+    // signalled the completion of their operations
+    const auto start = std::chrono::high_resolution_clock::now();
+    shared->start.store(true, std::memory_order_release);
+    const auto completed = await_children(shared->done, total_children, children);
+    const auto stop = std::chrono::high_resolution_clock::now();
+    const auto duration = stop - start;
+
+    // the remaining consumers can not complete, once any child has failed
+    if (!completed) {
+      kill_children(children);
+    }
+
+    const auto success = join_children(children) && completed;
+    ::munmap(addr, sizeof(sync_t));
+
+    if (!success) {
+      throw std::runtime_error("benchmark process failed (invalid or out-of-order element)");
+    }
+
+    // print measurements to stdout
+    std::cout
+        << "SHM-FAA"
+        << "," << producers
+        << "," << consumers
+        << "," << duration.count()
+        << "," << total_ops << std::endl;
+  }
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 3) {
+    throw std::invalid_argument("too few program arguments");
+  }
+
+  const auto total_ops = bench::parse_total_ops_str(argv[1]);
+  const auto runs = bench::parse_runs_str(argv[2]);
+  const auto producers = parse_process_count(argc, argv, 3);
+  const auto consumers = parse_process_count(argc, argv, 4);
+
+  bench_processes(total_ops, runs, producers, consumers);
+}
@@ -1,62 +1,535 @@
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <charconv>
+#include <concepts>
 #include <chrono>
+#include <cstdint>
 #include <functional>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <numeric>
+#include <optional>
+#include <random>
 #include <span>
 #include <stdexcept>
+#include <string>
 #include <string_view>
+#include <system_error>
 #include <thread>
 #include <vector>
 
-#include "boost/thread/barrier.hpp"
+#include <sys/epoll.h>
+#include <unistd.h>
 
+#include "alloc_stats.hpp"
 #include "common.hpp"
+#include "histogram.hpp"
+#include "perf_counters.hpp"
+#include "queue_events.hpp"
+#include "results.hpp"
+#include "think_time.hpp"
+#include "topology.hpp"
+#include "worker_pool.hpp"
+#include "queues/coro/async_queue.hpp"
+#include "queues/coro/executor.hpp"
+#include "queues/evt/eventfd_queue.hpp"
 #include "queues/faa/faa_array.hpp"
+#include "queues/fc/flat_combining.hpp"
+#include "queues/hrq/hierarchical.hpp"
+#include "queues/kpq/kogan_petrank.hpp"
 #include "queues/lcr/lcrq.hpp"
 #include "queues/msc/michael_scott.hpp"
 #include "queues/lsc/lscq.hpp"
+#include "queues/mpsc/mpsc_segment.hpp"
+#include "queues/mtx/mutex_deque.hpp"
+#include "queues/shd/sharded.hpp"
+#include "queues/spsc/spsc_ring.hpp"
+#include "queues/tkt/ticket_ring.hpp"
+#include "queues/tlq/two_lock.hpp"
 #include "queues/queue_ref.hpp"
+#include "sched/fork_join.hpp"
 
 #include "looqueue/queue.hpp"
 #include "ymcqueue/queue.hpp"
 
 constexpr std::array<std::size_t, 11> THREADS{ 1, 2, 4, 8, 16, 24, 32, 48, 64, 80, 96 };
+/** number of elements enqueued at once in the `bulk` benchmark */
+constexpr std::size_t BULK_BATCH_SIZE = 4096;
+/** delay between two enqueues of the same producer in the `notify` benchmark,
+ *  so that the consumer regularly finds the queue empty */
+constexpr std::size_t NOTIFY_DELAY_NS = 500;
+/** maximum number of elements dequeued at once in the `notify` benchmark */
+constexpr std::size_t NOTIFY_BATCH_SIZE = 64;
+/** number of pushes after which a producer task yields in the `async`
+ *  benchmark, so that other tasks can run on the same executor thread */
+constexpr std::size_t ASYNC_YIELD_INTERVAL = 64;
+/** work per element of each working stage in the default `pipeline` bench */
+constexpr std::size_t PIPELINE_WORK_NS = 250;
+/** delay between two samples of the queue occupancies in the `pipeline` bench */
+constexpr std::size_t PIPELINE_SAMPLE_INTERVAL_NS = 1000;
+/** fractions of the measured saturation throughput offered by the producers of
+ *  the `openloop` bench, unless a fixed rate is given */
+constexpr std::array<double, 5> OPEN_LOOP_LOADS{ 0.1, 0.3, 0.5, 0.7, 0.9 };
 
 using faa::detail::queue_variant_t;
 using thread_span_t = std::span<const std::size_t>;
 
 /********** queue aliases *****************************************************/
 
-using loo_queue        = loo::queue<std::size_t>;
-
-using faa_queue        = faa::queue<std::size_t>;
-using faa_queue_ref    = faa::queue_ref<std::size_t>;
-using faa_queue_v1     = faa::queue<std::size_t, queue_variant_t::VARIANT_1>;
-using faa_queue_v1_ref = faa::queue_ref_v1<std::size_t>;
-using faa_queue_v2     = faa::queue<std::size_t, queue_variant_t::VARIANT_2>;
-using faa_queue_v2_ref = faa::queue_ref_v2<std::size_t>;
-using faa_queue_v3     = faa::queue<std::size_t, queue_variant_t::VARIANT_3>;
-using faa_queue_v3_ref = faa::queue_ref_v3<std::size_t>;
-using lcr_queue        = lcr::queue<std::size_t>;
-using lcr_queue_ref    = lcr::queue_ref<std::size_t>;
-using lscqd_queue      = scq::d::queue<std::size_t>;
-using lscqd_queue_ref  = scq::d::queue_ref<std::size_t>;
-using lscq2_queue      = scq::cas2::queue<std::size_t>;
-using lscq2_queue_ref  = scq::cas2::queue_ref<std::size_t>;
-using msc_queue        = msc::queue<std::size_t>;
-using msc_queue_ref    = msc::queue_ref<std::size_t>;
-using ymc_queue        = ymc::queue<std::size_t>;
-using ymc_queue_ref    = queue_ref<ymc_queue>;
+using loo_queue         = loo::queue<std::size_t>;
+
+using faa_queue         = faa::queue<std::size_t>;
+using faa_queue_ref     = faa::queue_ref<std::size_t>;
+using faa_queue_v1      = faa::queue<std::size_t, queue_variant_t::VARIANT_1>;
+using faa_queue_v1_ref  = faa::queue_ref_v1<std::size_t>;
+using faa_queue_v2      = faa::queue<std::size_t, queue_variant_t::VARIANT_2>;
+using faa_queue_v2_ref  = faa::queue_ref_v2<std::size_t>;
+using faa_queue_v3      = faa::queue<std::size_t, queue_variant_t::VARIANT_3>;
+using faa_queue_v3_ref  = faa::queue_ref_v3<std::size_t>;
+using fc_queue          = fc::queue<std::size_t>;
+using fc_queue_ref      = fc::queue_ref<std::size_t>;
+using hrq_queue         = hrq::queue<std::size_t>;
+using hrq_queue_ref     = hrq::queue_ref<std::size_t>;
+using kpq_queue         = kpq::queue<std::size_t>;
+using kpq_queue_ref     = kpq::queue_ref<std::size_t>;
+using lcr_queue         = lcr::queue<std::size_t>;
+using lcr_queue_ref     = lcr::queue_ref<std::size_t>;
+using lscqd_queue       = scq::d::queue<std::size_t>;
+using lscqd_queue_ref   = scq::d::queue_ref<std::size_t>;
+using lscq2_queue       = scq::cas2::queue<std::size_t>;
+using lscq2_queue_ref   = scq::cas2::queue_ref<std::size_t>;
+using msc_queue         = msc::queue<std::size_t>;
+using msc_queue_ref     = msc::queue_ref<std::size_t>;
+using mtx_queue         = mtx::queue<std::size_t>;
+using mtx_queue_ref     = mtx::queue_ref<std::size_t>;
+using tkt_queue         = tkt::queue<std::size_t>;
+using tkt_queue_ref     = tkt::queue_ref<std::size_t>;
+using tlq_queue         = tlq::queue<std::size_t>;
+using tlq_queue_ref     = tlq::queue_ref<std::size_t>;
+using shd_queue         = shd::faa_queue<std::size_t>;
+using shd_queue_ref     = shd::faa_queue_ref<std::size_t>;
+using shd_lcr_queue     = shd::lcr_queue<std::size_t>;
+using shd_lcr_queue_ref = shd::lcr_queue_ref<std::size_t>;
+using spsc_queue        = spsc::queue<std::size_t>;
+using spsc_queue_ref    = spsc::queue_ref<std::size_t>;
+using mpsc_queue        = mpsc::queue<std::size_t>;
+using mpsc_queue_ref    = mpsc::queue_ref<std::size_t>;
+using ymc_queue         = ymc::queue<std::size_t>;
+using ymc_queue_ref     = queue_ref<ymc_queue>;
 
 /********** function pointer aliases ******************************************/
 
 template <typename Q, typename R>
 using make_queue_ref_fn = std::function<R(Q&, std::size_t)>;
 
+/********** queue traits ******************************************************/
+
+/** true if the queue supports only a single enqueueing thread */
+template <typename Q>
+constexpr bool is_single_producer() {
+  if constexpr (requires { Q::SINGLE_PRODUCER; }) {
+    return Q::SINGLE_PRODUCER;
+  } else {
+    return false;
+  }
+}
+
+/** true if the queue supports only a single dequeueing thread */
+template <typename Q>
+constexpr bool is_single_consumer() {
+  if constexpr (requires { Q::SINGLE_CONSUMER; }) {
+    return Q::SINGLE_CONSUMER;
+  } else {
+    return false;
+  }
+}
+
+/** true if the queue supports appending a batch of elements at once */
+template <typename Q>
+concept SegmentQueue = requires(Q& queue, std::span<const typename Q::pointer> elems) {
+  queue.enqueue_segment(elems, std::size_t{ 0 });
+};
+
+/** true if the queue can estimate its number of elements */
+template <typename Q>
+concept SizedQueue = requires(Q& queue) {
+  { queue.approx_size(std::size_t{ 0 }) } -> std::convertible_to<std::size_t>;
+};
+
+/** true if the queue takes the calling thread's id as explicit argument */
+template <typename Q>
+concept ThreadIdQueue = requires(Q& queue, typename Q::pointer elem) {
+  queue.enqueue(elem, std::size_t{ 0 });
+  { queue.dequeue(std::size_t{ 0 }) } -> std::same_as<typename Q::pointer>;
+};
+
 /********** functions *********************************************************/
 
+/** enqueues the batch at once, if the queue supports it, or element-wise */
+template <typename Q, typename R>
+void enqueue_batch(
+    Q&                            queue,
+    R&                            queue_ref,
+    std::span<std::size_t* const> elems,
+    std::size_t                   thread_id
+) {
+  if constexpr (SegmentQueue<Q>) {
+    queue.enqueue_segment(elems, thread_id);
+  } else {
+    for (const auto elem : elems) {
+      queue_ref.enqueue(elem);
+    }
+  }
+}
+
+/**
+ * Control of a single bench run, which ends each thread's operation loop after
+ * a fixed number of operations or, in fixed-duration mode, once the run's
+ * time is up.
+ *
+ * Also collects the number of operations performed by each thread and, if
+ * enabled, each thread's number of empty dequeues, elapsed time and hardware
+ * performance counters.
+ */
+class run_control {
+public:
+  /** constructor */
+  run_control(const bench::options_t& options, std::size_t threads) :
+    m_duration{ options.duration_ms },
+    m_thread_stats_enabled{ options.thread_stats },
+    m_thread_ops(threads, 0),
+    m_thread_stats(threads)
+  {
+    if (options.perf_counters) {
+      this->m_perf = std::make_unique<bench::perf_counters[]>(threads);
+    }
+  }
+
+  [[nodiscard]] bool timed() const noexcept {
+    return this->m_duration.count() != 0;
+  }
+
+  /** returns `ops`, unless timed, in which case the number of operations is
+   *  not bounded */
+  [[nodiscard]] std::size_t ops_limit(std::size_t ops) const noexcept {
+    return this->timed() ? std::numeric_limits<std::size_t>::max() : ops;
+  }
+
+  /** returns false once the time is up, always true unless timed */
+  [[nodiscard]] bool running() const noexcept {
+    return !this->timed() || this->m_phase.load(std::memory_order_relaxed) != STOPPED;
+  }
+
+  /** returns true if the calling thread may perform its `op`-th operation of
+   *  at most `ops` (unless timed, `ops` is its fixed number of operations) */
+  [[nodiscard]] bool proceed(std::size_t op, std::size_t ops) const noexcept {
+    return op < ops && this->running();
+  }
+
+  /** returns true once the calling thread is in the second half of its run,
+   *  either by its number of operations or by time */
+  [[nodiscard]] bool second_half(std::size_t op, std::size_t ops) const noexcept {
+    return this->timed()
+        ? this->m_phase.load(std::memory_order_relaxed) != FIRST_HALF
+        : op >= ops / 2;
+  }
+
+  /** must be called by the main thread once the run has started, returns once
+   *  the time is up or immediately, if the run is not timed */
+  void await_end() {
+    if (this->timed()) {
+      std::this_thread::sleep_for(this->m_duration / 2);
+      this->m_phase.store(SECOND_HALF, std::memory_order_relaxed);
+      std::this_thread::sleep_for(this->m_duration - this->m_duration / 2);
+      this->m_phase.store(STOPPED, std::memory_order_relaxed);
+    }
+  }
+
+  /** opens the calling thread's performance counters, if enabled, must be
+   *  called before the start barrier */
+  void prepare_thread(std::size_t thread) {
+    if (this->m_perf != nullptr && !this->m_perf[thread].open()) {
+      bench::warn_perf_unavailable();
+    }
+  }
+
+  /** starts (or resumes) measuring the calling thread's elapsed time and
+   *  performance counters, must be called right after the start barrier */
+  void start_thread(std::size_t thread) noexcept {
+    if (this->m_thread_stats_enabled) {
+      auto& stats = this->m_thread_stats[thread];
+      stats.start = std::chrono::steady_clock::now();
+      if (stats.first_start == std::chrono::steady_clock::time_point{}) {
+        stats.first_start = stats.start;
+      }
+    }
+
+    if (this->m_perf != nullptr) {
+      this->m_perf[thread].enable();
+    }
+  }
+
+  /** pauses measuring the calling thread's elapsed time and counters */
+  void stop_thread(std::size_t thread) noexcept {
+    if (this->m_perf != nullptr) {
+      this->m_perf[thread].disable();
+    }
+
+    if (this->m_thread_stats_enabled) {
+      auto& stats = this->m_thread_stats[thread];
+      stats.last_stop = std::chrono::steady_clock::now();
+      stats.elapsed += stats.last_stop - stats.start;
+    }
+  }
+
+  /** records the calling thread's number of operations (of which `empty_deqs`
+   *  were dequeues finding the queue empty) and stops measuring its time */
+  void record_ops(std::size_t thread, std::size_t ops, std::size_t empty_deqs = 0) noexcept {
+    this->stop_thread(thread);
+    this->m_thread_ops[thread] = ops;
+    this->m_thread_stats[thread].empty_deqs = empty_deqs;
+  }
+
+  /** returns the actual number of operations, if timed, else `total_ops` */
+  [[nodiscard]] std::size_t total_ops(std::size_t total_ops) const noexcept {
+    if (!this->timed()) {
+      return total_ops;
+    }
+
+    return std::accumulate(this->m_thread_ops.begin(), this->m_thread_ops.end(), std::size_t{ 0 });
+  }
+
+  /** appends the throughput and each thread's number of operations (separated
+   *  by '/') to the current line of output, if the run is timed, followed by
+   *  the performance counters, the per-thread statistics, the queue events and
+   *  the allocations per operation (of the `ops` printed in the line), if
+   *  enabled */
+  template <typename D>
+  void print_thread_ops(D duration, std::size_t ops) const {
+    if (this->timed()) {
+      const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+      const auto total = static_cast<double>(this->total_ops(0));
+      std::cout << "," << total * 1e9 / static_cast<double>(std::max<std::int64_t>(ns, 1)) << ",";
+      this->print_per_thread([&](std::size_t thread) { return this->m_thread_ops[thread]; });
+    }
+
+    if (this->m_perf != nullptr) {
+      this->print_perf_counters();
+    }
+
+    if (this->m_thread_stats_enabled) {
+      this->print_thread_stats();
+    }
+
+    events::print_totals(std::cout);
+    alloc::print_totals(std::cout, ops);
+  }
+
+private:
+  static constexpr int FIRST_HALF  = 0;
+  static constexpr int SECOND_HALF = 1;
+  static constexpr int STOPPED     = 2;
+
+  /** statistics of one thread, only accessed by itself until the run ends */
+  struct alignas(CACHE_LINE_ALIGN) thread_stats_t {
+    std::chrono::steady_clock::time_point start{ };
+    /** the time the thread first started and last stopped measuring */
+    std::chrono::steady_clock::time_point first_start{ };
+    std::chrono::steady_clock::time_point last_stop{ };
+    std::chrono::nanoseconds              elapsed{ 0 };
+    std::size_t                           empty_deqs{ 0 };
+  };
+
+  /** appends the value of each thread, separated by '/' */
+  template <typename F>
+  void print_per_thread(F&& value) const {
+    for (std::size_t thread = 0; thread < this->m_thread_ops.size(); ++thread) {
+      std::cout << (thread == 0 ? "" : "/") << value(thread);
+    }
+  }
+
+  /** appends the sum of each event over all threads per operation, in the order
+   *  of `bench::PERF_EVENTS` (or '-' if no thread could count the event),
+   *  followed by the context switches per operation */
+  void print_perf_counters() const {
+    const auto threads = this->m_thread_ops.size();
+    const auto ops = static_cast<double>(std::max<std::size_t>(
+        std::accumulate(this->m_thread_ops.begin(), this->m_thread_ops.end(), std::size_t{ 0 }), 1
+    ));
+
+    bench::perf_counters::values_t sums{};
+    std::uint64_t context_switches = 0;
+    for (std::size_t thread = 0; thread < threads; ++thread) {
+      const auto values = this->m_perf[thread].read();
+      for (std::size_t idx = 0; idx < sums.size(); ++idx) {
+        if (values[idx].has_value()) {
+          sums[idx] = sums[idx].value_or(0) + *values[idx];
+        }
+      }
+
+      context_switches += this->m_perf[thread].context_switches();
+    }
+
+    for (const auto& sum : sums) {
+      if (sum.has_value()) {
+        std::cout << "," << static_cast<double>(*sum) / ops;
+      } else {
+        std::cout << ",-";
+      }
+    }
+
+    std::cout << "," << static_cast<double>(context_switches) / ops;
+  }
+
+  /** appends Jain's fairness index, the minimum and maximum of the threads'
+   *  operation rates (per second) and the spread of their start and of their
+   *  stop times (in nanoseconds), followed by each thread's number of
+   *  operations, empty dequeues and elapsed time (in nanoseconds) */
+  void print_thread_stats() const {
+    const auto rate = [&](std::size_t thread) {
+      const auto ns = this->m_thread_stats[thread].elapsed.count();
+      return static_cast<double>(this->m_thread_ops[thread]) * 1e9 / static_cast<double>(std::max<std::int64_t>(ns, 1));
+    };
+
+    double sum = 0.0, sum_squares = 0.0;
+    auto min_rate = std::numeric_limits<double>::max();
+    auto max_rate = 0.0;
+    for (std::size_t thread = 0; thread < this->m_thread_ops.size(); ++thread) {
+      const auto thread_rate = rate(thread);
+      sum += thread_rate;
+      sum_squares += thread_rate * thread_rate;
+      min_rate = std::min(min_rate, thread_rate);
+      max_rate = std::max(max_rate, thread_rate);
+    }
+
+    // (sum x)^2 / (n * sum x^2) is 1 if all rates are equal and 1/n if only a
+    // single thread made any progress
+    const auto threads = static_cast<double>(this->m_thread_ops.size());
+    const auto jain = sum_squares == 0.0 ? 0.0 : sum * sum / (threads * sum_squares);
+
+    // the skew is the time between the first and the last thread to leave
+    // the start barrier (or to stop)
+    const auto [min_start, max_start] = std::minmax_element(
+        this->m_thread_stats.begin(), this->m_thread_stats.end(),
+        [](const auto& lhs, const auto& rhs) { return lhs.first_start < rhs.first_start; }
+    );
+    const auto [min_stop, max_stop] = std::minmax_element(
+        this->m_thread_stats.begin(), this->m_thread_stats.end(),
+        [](const auto& lhs, const auto& rhs) { return lhs.last_stop < rhs.last_stop; }
+    );
+    const std::chrono::nanoseconds start_skew = max_start->first_start - min_start->first_start;
+    const std::chrono::nanoseconds stop_skew = max_stop->last_stop - min_stop->last_stop;
+
+    std::cout
+        << "," << jain << "," << min_rate << "," << max_rate
+        << "," << start_skew.count() << "," << stop_skew.count() << ",";
+    this->print_per_thread([&](std::size_t thread) { return this->m_thread_ops[thread]; });
+    std::cout << ",";
+    this->print_per_thread([&](std::size_t thread) { return this->m_thread_stats[thread].empty_deqs; });
+    std::cout << ",";
+    this->print_per_thread([&](std::size_t thread) { return this->m_thread_stats[thread].elapsed.count(); });
+  }
+
+  const std::chrono::milliseconds           m_duration;
+  const bool                                m_thread_stats_enabled;
+  std::vector<std::size_t>                  m_thread_ops;
+  std::vector<thread_stats_t>               m_thread_stats;
+  std::unique_ptr<bench::perf_counters[]>   m_perf{ nullptr };
+  alignas(CACHE_LINE_ALIGN) std::atomic<int> m_phase{ FIRST_HALF };
+};
+
+/** discards everything printed to stdout while it exists */
+class discard_output {
+public:
+  discard_output() : m_stdout{ std::cout.rdbuf(&this->m_null) } {}
+
+  ~discard_output() noexcept {
+    std::cout.rdbuf(this->m_stdout);
+  }
+
+  discard_output(const discard_output&)            = delete;
+  discard_output(discard_output&&)                 = delete;
+  discard_output& operator=(const discard_output&) = delete;
+  discard_output& operator=(discard_output&&)      = delete;
+
+private:
+  struct null_buf : std::streambuf {
+    int_type overflow(int_type ch) override {
+      return traits_type::not_eof(ch);
+    }
+  };
+
+  null_buf        m_null{ };
+  std::streambuf* m_stdout;
+};
+
+/** returns for each of the `threads` threads, whether it is a producer, the
+ *  threads are split according to the ratio (with at least one of each role) */
+std::vector<bool> assign_producers(
+    std::size_t             threads,
+    bench::weights_t        ratio,
+    bench::role_placement_t placement
+) {
+  const auto total_weight = ratio.first + ratio.second;
+  auto producers = (threads * ratio.first + total_weight / 2) / total_weight;
+  producers = std::clamp<std::size_t>(producers, 1, threads - 1);
+
+  std::vector<bool> res(threads, false);
+  if (placement == bench::role_placement_t::GROUPED) {
+    std::fill(res.begin(), res.begin() + producers, true);
+    return res;
+  }
+
+  // spreads the smaller group evenly (starting at thread 0) between the other
+  const auto consumers = threads - producers;
+  const auto minority = std::min(producers, consumers);
+  for (std::size_t thread = 0; thread < threads; ++thread) {
+    const auto is_minority = (thread * minority) % threads < minority;
+    res[thread] = producers <= consumers ? is_minority : !is_minority;
+  }
+
+  return res;
+}
+
+/** returns the exact latency sample at the given percentile, reorders the
+ *  samples */
+std::uint32_t sample_percentile(std::vector<std::uint32_t>& samples, double pct) {
+  if (samples.empty()) {
+    return 0;
+  }
+
+  const auto rank = static_cast<std::size_t>(pct / 100.0 * (samples.size() - 1));
+  std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+  return samples[rank];
+}
+
+/** appends the percentiles of the merged per-thread enqueue and dequeue (or
+ *  any other two kinds of) latency histograms (in nanoseconds) to the current
+ *  line of output */
+void print_latencies(
+    const std::vector<bench::histogram>& enq_hists,
+    const std::vector<bench::histogram>& deq_hists
+) {
+  const auto ns = [](std::uint64_t cycles) {
+    return static_cast<std::uint64_t>(static_cast<double>(cycles) * bench::ns_per_cycle());
+  };
+
+  for (const auto hists : { &enq_hists, &deq_hists }) {
+    bench::histogram merged{};
+    for (const auto& hist : *hists) {
+      merged.merge(hist);
+    }
+
+    for (const auto pct : { 50.0, 90.0, 99.0, 99.9 }) {
+      std::cout << "," << ns(merged.percentile(pct));
+    }
+
+    std::cout << "," << ns(merged.max());
+  }
+}
+
 /** runs all bench iterations for the specified bench and queue */
 template <typename Q, typename R>
 void run_benches(
@@ -65,6 +538,7 @@ void run_benches(
     std::size_t             total_ops,
     std::size_t             runs,
     thread_span_t           threads_range,
+    const bench::options_t& options,
     make_queue_ref_fn<Q, R> make_queue_ref
 );
 
@@ -75,6 +549,7 @@ void bench_pairwise(
     std::size_t             total_ops,
     std::size_t             runs,
     std::size_t             threads,
+    const bench::options_t& options,
     make_queue_ref_fn<Q, R> make_queue_ref
 );
 
@@ -85,10 +560,12 @@ void bench_bursts(
     std::size_t             total_ops,
     std::size_t             runs,
     std::size_t             threads,
+    const bench::options_t& options,
     make_queue_ref_fn<Q, R> make_queue_ref
 );
 
-/** runs either the read-heavy or write-heavy benchmark */
+/** runs the write-heavy, read-heavy or mixed benchmark, the producer/consumer
+ *  roles or per-thread operation mix may be overridden by the options */
 template <typename Q, typename R>
 void bench_reads_or_writes(
     std::string_view        queue_name,
@@ -96,6 +573,115 @@ void bench_reads_or_writes(
     std::size_t             total_ops,
     std::size_t             runs,
     std::size_t             threads,
+    const bench::options_t& options,
+    make_queue_ref_fn<Q, R> make_queue_ref
+);
+
+/** runs the pairwise benchmark measuring the deviation from global FIFO order */
+template <typename Q, typename R>
+void bench_rank_error(
+    std::string_view        queue_name,
+    std::size_t             total_ops,
+    std::size_t             runs,
+    std::size_t             threads,
+    const bench::options_t& options,
+    make_queue_ref_fn<Q, R> make_queue_ref
+);
+
+/** runs the pairwise benchmark measuring the latency of every operation */
+template <typename Q, typename R>
+void bench_latency(
+    std::string_view        queue_name,
+    std::size_t             total_ops,
+    std::size_t             runs,
+    std::size_t             threads,
+    const bench::options_t& options,
+    make_queue_ref_fn<Q, R> make_queue_ref
+);
+
+/** runs randomized enqueue/dequeue operations while one additional thread
+ *  measures the cost and accuracy of the queue's approximate size */
+template <typename Q, typename R>
+void bench_approx_size(
+    std::string_view        queue_name,
+    std::size_t             total_ops,
+    std::size_t             runs,
+    std::size_t             threads,
+    const bench::options_t& options,
+    make_queue_ref_fn<Q, R> make_queue_ref
+);
+
+/** runs the benchmark with dedicated producer and consumer threads, producers
+ *  enqueue in batches of `batch_size` elements unless it is 0 */
+template <typename Q, typename R>
+void bench_producers_consumers(
+    std::string_view        queue_name,
+    std::size_t             total_ops,
+    std::size_t             runs,
+    std::size_t             producers,
+    std::size_t             consumers,
+    std::size_t             batch_size,
+    const bench::options_t& options,
+    make_queue_ref_fn<Q, R> make_queue_ref
+);
+
+/** runs the benchmark with one consumer waiting for elements in an `epoll`
+ *  event loop (using `evt::queue`) and with one spin-polling consumer */
+template <typename Q>
+void bench_notify(
+    std::string_view        queue_name,
+    std::size_t             total_ops,
+    std::size_t             runs,
+    std::size_t             producers,
+    const bench::options_t& options
+);
+
+/** runs the producer/consumer benchmark with plain threads (using `queue_ref`)
+ *  and with coroutines (using `coro::queue`) on a single-threaded and on a
+ *  multi-threaded executor */
+template <typename Q>
+void bench_async(
+    std::string_view        queue_name,
+    std::size_t             total_ops,
+    std::size_t             runs,
+    std::size_t             threads,
+    const bench::options_t& options
+);
+
+/** runs the benchmark, in which elements pass through a chain of stages with
+ *  one queue between each two consecutive stages */
+template <typename Q, typename R>
+void bench_pipeline(
+    std::string_view                         queue_name,
+    std::size_t                              total_ops,
+    std::size_t                              runs,
+    std::span<const bench::pipeline_stage_t> stages,
+    const bench::options_t&                  options,
+    make_queue_ref_fn<Q, R>                  make_queue_ref
+);
+
+/** runs the benchmark, in which the producers enqueue on a fixed or Poisson
+ *  schedule at a given rate (open-loop) and the consumers measure the latency
+ *  of each element from its intended and from its actual send time */
+template <typename Q, typename R>
+void bench_open_loop(
+    std::string_view        queue_name,
+    std::size_t             total_ops,
+    std::size_t             runs,
+    std::size_t             producers,
+    std::size_t             consumers,
+    const bench::options_t& options,
+    make_queue_ref_fn<Q, R> make_queue_ref
+);
+
+/** runs all fork-join workloads on a `sched::fork_join_pool` using the queue
+ *  as its injection queue, both in shared and in work-stealing mode */
+template <typename Q, typename R>
+void bench_fork_join(
+    std::string_view        queue_name,
+    std::size_t             runs,
+    std::size_t             threads,
+    const bench::options_t& options,
     make_queue_ref_fn<Q, R> make_queue_ref
 );
 
@@ -119,7 +705,13 @@ thread_span_t extract_thread_span(
 }
 
 int main(int argc, char* argv[5]) {
-  if (argc < 5) {
+  // the positional arguments are followed by optional `--key=value` arguments
+  auto positional = 1;
+  while (positional < argc && !std::string_view{ argv[positional] }.starts_with("--")) {
+    ++positional;
+  }
+
+  if (positional < 5) {
     throw std::invalid_argument("too few program arguments");
   }
 
@@ -134,14 +726,39 @@ int main(int argc, char* argv[5]) {
   const auto runs = bench::parse_runs_str(runs_str);
 
   auto alternative_thread_range = std::to_array({ static_cast<std::size_t>(0) });
-  const auto threads = extract_thread_span(argc, argv, alternative_thread_range);
+  const auto threads = extract_thread_span(positional, argv, alternative_thread_range);
+  const auto options = bench::parse_options(std::span(argv + positional, argv + argc));
 
   const std::string_view queue_name{ bench::display_str(queue_type) };
 
+  // pins the threads according to the affinity policy, the mapping is printed
+  // (and recorded in the `--output` file) unless thread `i` runs on CPU `i`
+  const auto cpus = bench::affinity_cpus(options);
+  if (options.affinity != bench::affinity_t::LINEAR) {
+    std::cerr << "affinity " << bench::display_str(options.affinity) << ", threads pinned to CPUs ";
+    for (std::size_t idx = 0; idx < cpus.size(); ++idx) {
+      std::cerr << (idx == 0 ? "" : "/") << cpus[idx];
+    }
+
+    std::cerr << std::endl;
+  }
+
+  topology::set_thread_cpus(cpus);
+
+  // measures the time stamp counter's frequency, by which `spin_for_ns` times
+  // the think times and the stage work, before rather than within the first run
+  bench::spin_for_ns(0);
+
+  // collects everything printed to stdout for the `--output` file, if given
+  std::optional<bench::results_writer> results{};
+  if (!options.output.empty()) {
+    results.emplace(bench_type, total_ops, runs, options, std::span(argv, argv + argc));
+  }
+
   switch (queue_type) {
     case bench::queue_type_t::LCR:
       run_benches<lcr_queue, lcr_queue_ref>(
-          queue_name, bench_type, total_ops, runs, threads,
+          queue_name, bench_type, total_ops, runs, threads, options,
           [](auto& queue, auto thread_id) -> auto {
             return lcr_queue_ref(queue, thread_id);
           }
@@ -149,13 +766,13 @@ int main(int argc, char* argv[5]) {
       break;
     case bench::queue_type_t::LOO:
       run_benches<loo_queue, loo_queue&>(
-          queue_name, bench_type, total_ops, runs, threads,
+          queue_name, bench_type, total_ops, runs, threads, options,
           [](auto& queue, auto) -> auto& { return queue; }
       );
       break;
     case bench::queue_type_t::FAA:
       run_benches<faa_queue, faa_queue_ref>(
-          queue_name, bench_type, total_ops, runs, threads,
+          queue_name, bench_type, total_ops, runs, threads, options,
           [](auto& queue, auto thread_id) -> auto {
             return faa_queue_ref(queue, thread_id);
           }
@@ -163,7 +780,7 @@ int main(int argc, char* argv[5]) {
       break;
     case bench::queue_type_t::FAA_V1:
       run_benches<faa_queue_v1, faa_queue_v1_ref>(
-          queue_name, bench_type, total_ops, runs, threads,
+          queue_name, bench_type, total_ops, runs, threads, options,
           [](auto& queue, auto thread_id) -> auto {
             return faa_queue_v1_ref(queue, thread_id);
           }
@@ -171,7 +788,7 @@ int main(int argc, char* argv[5]) {
       break;
     case bench::queue_type_t::FAA_V2:
       run_benches<faa_queue_v2, faa_queue_v2_ref>(
-          queue_name, bench_type, total_ops, runs, threads,
+          queue_name, bench_type, total_ops, runs, threads, options,
           [](auto& queue, auto thread_id) -> auto {
             return faa_queue_v2_ref(queue, thread_id);
           }
@@ -179,7 +796,7 @@ int main(int argc, char* argv[5]) {
       break;
       case bench::queue_type_t::FAA_V3:
         run_benches<faa_queue_v3, faa_queue_v3_ref>(
-          queue_name, bench_type, total_ops, runs, threads,
+          queue_name, bench_type, total_ops, runs, threads, options,
           [](auto& queue, auto thread_id) -> auto {
             return faa_queue_v3_ref(queue, thread_id);
           }
@@ -187,7 +804,7 @@ int main(int argc, char* argv[5]) {
     break;
     case bench::queue_type_t::MSC:
       run_benches<msc_queue, msc_queue_ref>(
-          queue_name, bench_type, total_ops, runs, threads,
+          queue_name, bench_type, total_ops, runs, threads, options,
           [](auto& queue, auto thread_id) -> auto {
             return msc_queue_ref(queue, thread_id);
           }
@@ -195,7 +812,7 @@ int main(int argc, char* argv[5]) {
       break;
     case bench::queue_type_t::SCQ2:
       run_benches<lscq2_queue, lscq2_queue_ref>(
-          queue_name, bench_type, total_ops, runs, threads,
+          queue_name, bench_type, total_ops, runs, threads, options,
           [](auto& queue, auto thread_id) -> auto {
             return lscq2_queue_ref(queue, thread_id);
           }
@@ -203,7 +820,7 @@ int main(int argc, char* argv[5]) {
       break;
     case bench::queue_type_t::SCQD:
       run_benches<lscqd_queue, lscqd_queue_ref>(
-          queue_name, bench_type, total_ops, runs, threads,
+          queue_name, bench_type, total_ops, runs, threads, options,
           [](auto& queue, auto thread_id) -> auto {
             return lscqd_queue_ref(queue, thread_id);
           }
@@ -211,12 +828,96 @@ int main(int argc, char* argv[5]) {
       break;
     case bench::queue_type_t::YMC:
       run_benches<ymc_queue, ymc_queue_ref>(
-          queue_name, bench_type, total_ops, runs, threads,
+          queue_name, bench_type, total_ops, runs, threads, options,
           [](auto& queue, auto thread_id) -> auto {
             return ymc_queue_ref(queue, thread_id);
           }
       );
       break;
+    case bench::queue_type_t::FC:
+      run_benches<fc_queue, fc_queue_ref>(
+          queue_name, bench_type, total_ops, runs, threads, options,
+          [](auto& queue, auto thread_id) -> auto {
+            return fc_queue_ref(queue, thread_id);
+          }
+      );
+      break;
+    case bench::queue_type_t::MTX:
+      run_benches<mtx_queue, mtx_queue_ref>(
+          queue_name, bench_type, total_ops, runs, threads, options,
+          [](auto& queue, auto thread_id) -> auto {
+            return mtx_queue_ref(queue, thread_id);
+          }
+      );
+      break;
+    case bench::queue_type_t::TLQ:
+      run_benches<tlq_queue, tlq_queue_ref>(
+          queue_name, bench_type, total_ops, runs, threads, options,
+          [](auto& queue, auto thread_id) -> auto {
+            return tlq_queue_ref(queue, thread_id);
+          }
+      );
+      break;
+    case bench::queue_type_t::TKT:
+      run_benches<tkt_queue, tkt_queue_ref>(
+          queue_name, bench_type, total_ops, runs, threads, options,
+          [](auto& queue, auto thread_id) -> auto {
+            return tkt_queue_ref(queue, thread_id);
+          }
+      );
+      break;
+    case bench::queue_type_t::SHD:
+      run_benches<shd_queue, shd_queue_ref>(
+          queue_name, bench_type, total_ops, runs, threads, options,
+          [](auto& queue, auto thread_id) -> auto {
+            return shd_queue_ref(queue, thread_id);
+          }
+      );
+      break;
+    case bench::queue_type_t::SHD_LCR:
+      run_benches<shd_lcr_queue, shd_lcr_queue_ref>(
+          queue_name, bench_type, total_ops, runs, threads, options,
+          [](auto& queue, auto thread_id) -> auto {
+            return shd_lcr_queue_ref(queue, thread_id);
+          }
+      );
+      break;
+    case bench::queue_type_t::SPSC:
+      run_benches<spsc_queue, spsc_queue_ref>(
+          queue_name, bench_type, total_ops, runs, threads, options,
+          [](auto& queue, auto thread_id) -> auto {
+            return spsc_queue_ref(queue, thread_id);
+          }
+      );
+      break;
+    case bench::queue_type_t::MPSC:
+      run_benches<mpsc_queue, mpsc_queue_ref>(
+          queue_name, bench_type, total_ops, runs, threads, options,
+          [](auto& queue, auto thread_id) -> auto {
+            return mpsc_queue_ref(queue, thread_id);
+          }
+      );
+      break;
+    case bench::queue_type_t::KPQ:
+      run_benches<kpq_queue, kpq_queue_ref>(
+          queue_name, bench_type, total_ops, runs, threads, options,
+          [](auto& queue, auto thread_id) -> auto {
+            return kpq_queue_ref(queue, thread_id);
+          }
+      );
+      break;
+    case bench::queue_type_t::HRQ:
+      run_benches<hrq_queue, hrq_queue_ref>(
+          queue_name, bench_type, total_ops, runs, threads, options,
+          [](auto& queue, auto thread_id) -> auto {
+            return hrq_queue_ref(queue, thread_id);
+          }
+      );
+      break;
+  }
+
+  if (results.has_value()) {
+    results->finish();
   }
 }
 
@@ -227,47 +928,230 @@ void run_benches(
     std::size_t             total_ops,
     std::size_t             runs,
     thread_span_t           threads_range,
+    const bench::options_t& options,
     make_queue_ref_fn<Q, R> make_queue_ref
 ) {
-  if (bench_type == bench::bench_type_t::PAIRS || bench_type == bench::bench_type_t::BURSTS) {
+  const auto is_single_consumer_bench =
+      bench_type == bench::bench_type_t::SPSC
+      || bench_type == bench::bench_type_t::MPSC
+      || bench_type == bench::bench_type_t::NOTIFY;
+  const auto is_role_bench =
+      is_single_consumer_bench
+      || bench_type == bench::bench_type_t::BULK
+      || bench_type == bench::bench_type_t::ASYNC
+      || bench_type == bench::bench_type_t::OPENLOOP;
+
+  const auto max_threads = bench::max_threads(options);
+
+  // executes the bench with as many additional warm-up runs first, whose output
+  // is discarded
+  const auto measure = [&](auto&& bench_fn) {
+    if (options.warmup != 0) {
+      const discard_output discard{};
+      bench_fn(options.warmup);
+    }
+
+    bench_fn(runs);
+  };
+
+  if (is_single_consumer<Q>() && !is_single_consumer_bench) {
+    throw std::invalid_argument("single consumer queues only support the 'spsc', 'mpsc' and 'notify' benches");
+  }
+
+  if (is_single_producer<Q>() && bench_type != bench::bench_type_t::SPSC) {
+    throw std::invalid_argument("single producer queues only support the 'spsc' bench");
+  }
+
+  const auto is_fixed_work_bench =
+      bench_type == bench::bench_type_t::NOTIFY
+      || bench_type == bench::bench_type_t::ASYNC
+      || bench_type == bench::bench_type_t::FORKJOIN
+      || bench_type == bench::bench_type_t::OPENLOOP;
+  if (options.duration_ms != 0 && is_fixed_work_bench) {
+    throw std::invalid_argument(
+        "the 'notify', 'async', 'forkjoin' and 'openloop' benches do not support '--duration'"
+    );
+  }
+
+  if (is_role_bench) {
+    if (bench_type == bench::bench_type_t::SPSC) {
+      // the thread range is ignored, exactly one producer and one consumer
+      measure([&](std::size_t runs) {
+        bench_producers_consumers<Q, R>(queue_name, total_ops, runs, 1, 1, 0, options, make_queue_ref);
+      });
+      return;
+    }
+
+    for (auto threads : threads_range) {
+      if (threads < 2) {
+        continue;
+      }
+
+      // aborts if threads would have to share a core (unless the affinity
+      // policy deliberately uses SMT siblings)
+      if (threads > max_threads) {
+        break;
+      }
+
+      if (bench_type == bench::bench_type_t::MPSC) {
+        measure([&](std::size_t runs) {
+          bench_producers_consumers<Q, R>(
+              queue_name, total_ops, runs, threads - 1, 1, 0, options, make_queue_ref
+          );
+        });
+      } else if (bench_type == bench::bench_type_t::NOTIFY) {
+        measure([&](std::size_t runs) {
+          bench_notify<Q>(queue_name, total_ops, runs, threads - 1, options);
+        });
+      } else if (bench_type == bench::bench_type_t::ASYNC) {
+        measure([&](std::size_t runs) {
+          bench_async<Q>(queue_name, total_ops, runs, threads, options);
+        });
+      } else if (bench_type == bench::bench_type_t::OPENLOOP) {
+        measure([&](std::size_t runs) {
+          bench_open_loop<Q, R>(
+              queue_name, total_ops, runs, threads / 2, threads - threads / 2, options, make_queue_ref
+          );
+        });
+      } else {
+        measure([&](std::size_t runs) {
+          bench_producers_consumers<Q, R>(
+              queue_name, total_ops, runs, threads / 2, threads - threads / 2, BULK_BATCH_SIZE,
+              options, make_queue_ref
+          );
+        });
+      }
+    }
+  } else if (
+      bench_type == bench::bench_type_t::PAIRS
+      || bench_type == bench::bench_type_t::BURSTS
+      || bench_type == bench::bench_type_t::RANK
+      || bench_type == bench::bench_type_t::LATENCY
+      || bench_type == bench::bench_type_t::SIZE
+      || bench_type == bench::bench_type_t::FORKJOIN
+  ) {
+    if (bench_type == bench::bench_type_t::SIZE && !SizedQueue<Q>) {
+      throw std::invalid_argument("queue does not support the 'size' bench");
+    }
+
     for (auto threads : threads_range) {
-      // aborts if hyper-threads would be used (assuming 2 HT per core)
-      if (threads > std::thread::hardware_concurrency() / 2) {
+      // aborts if threads would have to share a core (unless the affinity
+      // policy deliberately uses SMT siblings), the size bench pins one
+      // additional sampler thread
+      const auto pinned = bench_type == bench::bench_type_t::SIZE ? threads + 1 : threads;
+      if (pinned > max_threads) {
         break;
       }
 
       switch (bench_type) {
         case bench::bench_type_t::PAIRS:
-          bench_pairwise<Q, R>(queue_name, total_ops, runs, threads, make_queue_ref);
+          measure([&](std::size_t runs) {
+            bench_pairwise<Q, R>(queue_name, total_ops, runs, threads, options, make_queue_ref);
+          });
           break;
         case bench::bench_type_t::BURSTS:
-          bench_bursts<Q, R>(queue_name, total_ops, runs, threads, make_queue_ref);
+          measure([&](std::size_t runs) {
+            bench_bursts<Q, R>(queue_name, total_ops, runs, threads, options, make_queue_ref);
+          });
+          break;
+        case bench::bench_type_t::RANK:
+          measure([&](std::size_t runs) {
+            bench_rank_error<Q, R>(queue_name, total_ops, runs, threads, options, make_queue_ref);
+          });
+          break;
+        case bench::bench_type_t::LATENCY:
+          measure([&](std::size_t runs) {
+            bench_latency<Q, R>(queue_name, total_ops, runs, threads, options, make_queue_ref);
+          });
+          break;
+        case bench::bench_type_t::SIZE:
+          measure([&](std::size_t runs) {
+            bench_approx_size<Q, R>(queue_name, total_ops, runs, threads, options, make_queue_ref);
+          });
+          break;
+        case bench::bench_type_t::FORKJOIN:
+          measure([&](std::size_t runs) {
+            bench_fork_join<Q, R>(queue_name, runs, threads, options, make_queue_ref);
+          });
           break;
         default: throw std::runtime_error("unreachable branch");
       }
     }
-  } else {
+  } else if (bench_type == bench::bench_type_t::PIPELINE) {
+    if (!options.stages.empty()) {
+      // the thread range is ignored, the stages determine all thread counts,
+      // which must not exceed the limit either (including the sampler thread)
+      std::size_t pinned = 1;
+      for (const auto& stage : options.stages) {
+        pinned += stage.threads;
+      }
+
+      if (pinned > max_threads) {
+        throw std::invalid_argument(
+            "option 'stages' requires " + std::to_string(pinned) + " threads (including the "
+            "sampler), but at most " + std::to_string(max_threads) + " can be pinned without "
+            "sharing a core"
+        );
+      }
+
+      measure([&](std::size_t runs) {
+        bench_pipeline<Q, R>(queue_name, total_ops, runs, options.stages, options, make_queue_ref);
+      });
+      return;
+    }
+
     for (auto threads : threads_range) {
       if (threads < 4) {
         continue;
       }
 
-      // aborts if hyper-threads would be used (assuming 2 HT per core)
-      if (threads > std::thread::hardware_concurrency() / 2) {
+      // aborts if threads would have to share a core (unless the affinity
+      // policy deliberately uses SMT siblings), including the sampler thread
+      if (threads + 1 > max_threads) {
         break;
       }
 
-      bench_reads_or_writes<Q, R>(queue_name, bench_type, total_ops, runs, threads, make_queue_ref);
+      // producers and sink each get a quarter of all threads, the remaining
+      // threads are split between two working stages
+      const auto quarter = threads / 4;
+      const auto workers = threads - 2 * quarter;
+      const auto stages = std::to_array<bench::pipeline_stage_t>({
+          { quarter, 0 },
+          { workers / 2, PIPELINE_WORK_NS },
+          { workers - workers / 2, PIPELINE_WORK_NS },
+          { quarter, 0 },
+      });
+
+      measure([&](std::size_t runs) {
+        bench_pipeline<Q, R>(queue_name, total_ops, runs, stages, options, make_queue_ref);
+      });
     }
-  }
-}
-
-template <typename Q, typename R>
-void bench_pairwise(
+  } else {
+    for (auto threads : threads_range) {
+      if (threads < 2) {
+        continue;
+      }
+
+      // aborts if threads would have to share a core (unless the affinity
+      // policy deliberately uses SMT siblings)
+      if (threads > max_threads) {
+        break;
+      }
+
+      measure([&](std::size_t runs) {
+        bench_reads_or_writes<Q, R>(queue_name, bench_type, total_ops, runs, threads, options, make_queue_ref);
+      });
+    }
+  }
+}
+
+template <typename Q, typename R>
+void bench_pairwise(
     std::string_view        queue_name,
     std::size_t             total_ops,
     std::size_t             runs,
     std::size_t             threads,
+    const bench::options_t& options,
     make_queue_ref_fn<Q, R> make_queue_ref
 ) {
   const auto ops_per_threads = total_ops / threads;
@@ -279,61 +1163,93 @@ void bench_pairwise(
     thread_ids.push_back(thread);
   }
 
+  // pre-allocates each thread's enqueue and dequeue latency histograms, which
+  // are only recorded into if enabled
+  std::vector<bench::histogram> enq_hists(threads), deq_hists(threads);
+
   // execute benchmark for `runs` iterations
   for (auto run = 0; run < runs; ++run) {
+    alloc::begin_run();
     auto queue = std::make_unique<Q>();
-    boost::barrier barrier{ static_cast<unsigned>(threads + 1) };
+    bench::spin_barrier barrier{ threads + 1 };
 
-    // pre-allocates a vector for storing each thread's join handle
-    std::vector<std::thread> thread_handles{};
-    thread_handles.reserve(threads);
+    run_control ctrl{ options, threads };
+    const auto ops_limit = ctrl.ops_limit(ops_per_threads);
 
-    // spawns threads and performs pairwise enqueue and dequeue operations
     for (auto thread = 0; thread < threads; ++thread) {
-      thread_handles.emplace_back(std::thread([&, thread] {
-        bench::pin_current_thread(thread);
+      enq_hists[thread].reset();
+      deq_hists[thread].reset();
+    }
+
+    // runs each thread on the persistent worker with the same id
+    auto& workers = bench::worker_pool::shared();
 
+    // spawns threads and performs pairwise enqueue and dequeue operations
+    for (auto thread = 0; thread < threads; ++thread) {
+      workers.spawn(thread, [&, thread] {
         auto&& queue_ref = make_queue_ref(*queue, thread);
+        bench::think_time think{ options.think, static_cast<std::size_t>(thread) };
+
+        ctrl.prepare_thread(thread);
 
         // all threads synchronize at this barrier before starting
         barrier.wait();
-
-        for (auto op = 0; op < ops_per_threads; ++op) {
-          if (op % 2 == 0) {
-            queue_ref.enqueue(&thread_ids.at(thread));
-          } else {
-            auto elem = queue_ref.dequeue();
-            if (elem != nullptr && (elem < &thread_ids.front() || elem > &thread_ids.back())) {
-              throw std::runtime_error(
-                  "invalid element retrieved (undefined behaviour detected)"
-              );
+        ctrl.start_thread(thread);
+
+        bench::with_op_timer(options.latency_interval, [&](auto timer) {
+          std::size_t op = 0, empty_deqs = 0;
+          for (; ctrl.proceed(op, ops_limit); ++op) {
+            const auto op_start = timer.start();
+            if (op % 2 == 0) {
+              queue_ref.enqueue(&thread_ids.at(thread));
+              timer.stop(enq_hists[thread], op_start);
+            } else {
+              auto elem = queue_ref.dequeue();
+              timer.stop(deq_hists[thread], op_start);
+              if (elem == nullptr) {
+                empty_deqs += 1;
+              } else if (elem < &thread_ids.front() || elem > &thread_ids.back()) {
+                throw std::runtime_error(
+                    "invalid element retrieved (undefined behaviour detected)"
+                );
+              }
             }
+
+            think.pause();
           }
-        }
+
+          ctrl.record_ops(thread, op, empty_deqs);
+        });
 
         // all threads synchronize at this barrier before completing
         barrier.wait();
-      }));
+      });
     }
 
     barrier.wait();
     // measures total time once all threads have arrived at the barrier
     const auto start = std::chrono::high_resolution_clock::now();
+    ctrl.await_end();
     barrier.wait();
     const auto stop = std::chrono::high_resolution_clock::now();
     const auto duration = stop - start;
 
-    // joins all threads
-    for (auto& handle : thread_handles) {
-      handle.join();
-    }
+    // waits for all workers to complete their jobs
+    workers.join_all();
 
     // print measurements to stdout
     std::cout
         << queue_name
         << "," << threads
         << "," << duration.count()
-        << "," << total_ops << std::endl;
+        << "," << ctrl.total_ops(total_ops);
+    if (options.latency_interval != 0) {
+      print_latencies(enq_hists, deq_hists);
+    }
+
+    ctrl.print_thread_ops(duration, ctrl.total_ops(total_ops));
+
+    std::cout << std::endl;
   }
 }
 
@@ -343,6 +1259,7 @@ void bench_bursts(
     std::size_t             total_ops,
     std::size_t             runs,
     std::size_t             threads,
+    const bench::options_t& options,
     make_queue_ref_fn<Q, R> make_queue_ref
 ) {
   const auto ops_per_threads = total_ops / threads;
@@ -354,46 +1271,82 @@ void bench_bursts(
     thread_ids.push_back(thread);
   }
 
+  // pre-allocates each thread's enqueue and dequeue latency histograms, which
+  // are only recorded into if enabled
+  std::vector<bench::histogram> enq_hists(threads), deq_hists(threads);
+
   // execute benchmark for `runs` iterations
   for (auto run = 0; run < runs; ++run) {
+    alloc::begin_run();
     auto queue = std::make_unique<Q>();
-    boost::barrier barrier{ static_cast<unsigned>(threads + 1) };
+    bench::spin_barrier barrier{ threads + 1 };
 
-    // pre-allocates a vector for storing each thread's join handle
-    std::vector<std::thread> thread_handles{};
-    thread_handles.reserve(threads);
+    run_control ctrl{ options, threads };
+    const auto ops_limit = ctrl.ops_limit(ops_per_threads);
 
-    // spawns threads and performs pairwise enqueue and dequeue operations
     for (auto thread = 0; thread < threads; ++thread) {
-      thread_handles.emplace_back(std::thread([&, thread] {
-        bench::pin_current_thread(thread);
+      enq_hists[thread].reset();
+      deq_hists[thread].reset();
+    }
 
+    // runs each thread on the persistent worker with the same id
+    auto& workers = bench::worker_pool::shared();
+
+    // spawns threads and performs pairwise enqueue and dequeue operations
+    for (auto thread = 0; thread < threads; ++thread) {
+      workers.spawn(thread, [&, thread] {
         auto&& queue_ref = make_queue_ref(*queue, thread);
+        bench::think_time think{ options.think, static_cast<std::size_t>(thread) };
+
+        ctrl.prepare_thread(thread);
 
         // (1) all threads synchronize at this barrier before starting
         barrier.wait();
+        ctrl.start_thread(thread);
+
+        // in fixed-duration mode, only the enqueue burst is timed and each
+        // thread then dequeues as many elements as it has enqueued
+        std::size_t enqueued = 0;
+        bench::with_op_timer(options.latency_interval, [&](auto timer) {
+          for (; ctrl.proceed(enqueued, ops_limit); ++enqueued) {
+            const auto op_start = timer.start();
+            queue_ref.enqueue(&thread_ids.at(thread));
+            timer.stop(enq_hists[thread], op_start);
+            think.pause();
+          }
+        });
 
-        for (auto op = 0; op < ops_per_threads; ++op) {
-          queue_ref.enqueue(&thread_ids.at(thread));
-        }
+        ctrl.stop_thread(thread);
 
         // (2) all threads synchronize at this barrier after completing their
         // respective enqueue burst
         barrier.wait();
+        ctrl.start_thread(thread);
 
-        for (auto op = 0; op < ops_per_threads; ++op) {
-          auto elem = queue_ref.dequeue();
-          // can never be null in fact
-          if (elem != nullptr && (elem < &thread_ids.front() || elem > &thread_ids.back())) {
-            throw std::runtime_error(
-                "invalid element retrieved (undefined behaviour detected)"
-            );
+        std::size_t empty_deqs = 0;
+        bench::with_op_timer(options.latency_interval, [&](auto timer) {
+          for (std::size_t op = 0; op < enqueued; ++op) {
+            const auto op_start = timer.start();
+            auto elem = queue_ref.dequeue();
+            timer.stop(deq_hists[thread], op_start);
+            // can in fact only be null for queues with relaxed ordering
+            if (elem == nullptr) {
+              empty_deqs += 1;
+            } else if (elem < &thread_ids.front() || elem > &thread_ids.back()) {
+              throw std::runtime_error(
+                  "invalid element retrieved (undefined behaviour detected)"
+              );
+            }
+
+            think.pause();
           }
-        }
+        });
+
+        ctrl.record_ops(thread, 2 * enqueued, empty_deqs);
 
         // (3) all threads synchronize at this barrier before completing
         barrier.wait();
-      }));
+      });
     }
 
     // (1)
@@ -401,6 +1354,7 @@ void bench_bursts(
     // measures total time of enqueue burst once all threads have arrived at the
     // barrier
     const auto enq_start = std::chrono::high_resolution_clock::now();
+    ctrl.await_end();
     // (2)
     barrier.wait();
     const auto enq_stop = std::chrono::high_resolution_clock::now();
@@ -411,10 +1365,8 @@ void bench_bursts(
     const auto enq = enq_stop - enq_start;
     const auto deq = deq_stop - enq_stop;
 
-    // joins all threads
-    for (auto& handle : thread_handles) {
-      handle.join();
-    }
+    // waits for all workers to complete their jobs
+    workers.join_all();
 
     // print measurements to stdout
     std::cout
@@ -422,7 +1374,14 @@ void bench_bursts(
         << "," << threads
         << "," << enq.count()
         << "," << deq.count()
-        << "," << total_ops << std::endl;
+        << "," << ctrl.total_ops(total_ops);
+    if (options.latency_interval != 0) {
+      print_latencies(enq_hists, deq_hists);
+    }
+
+    ctrl.print_thread_ops(enq + deq, ctrl.total_ops(total_ops));
+
+    std::cout << std::endl;
   }
 }
 
@@ -433,14 +1392,30 @@ void bench_reads_or_writes(
     std::size_t             total_ops,
     std::size_t             runs,
     std::size_t             threads,
+    const bench::options_t& options,
     make_queue_ref_fn<Q, R> make_queue_ref
 ) {
-  if (threads % 4 != 0) {
-    throw std::invalid_argument("argument `threads` must be multiple of four");
+  if (threads < 2) {
+    throw std::invalid_argument("argument `threads` must be at least two");
   }
 
   const auto ops_per_thread = total_ops / threads;
 
+  // the default ratios of producers to consumers are 3:1 for writes, 1:3 for
+  // reads and 1:1 for mixed
+  auto ratio = options.roles;
+  if (ratio.empty()) {
+    switch (bench_type) {
+      case bench::bench_type_t::WRITES: ratio = { 3, 1 }; break;
+      case bench::bench_type_t::READS:  ratio = { 1, 3 }; break;
+      case bench::bench_type_t::MIXED:  ratio = { 1, 1 }; break;
+      default: throw std::runtime_error("unreachable branch");
+    }
+  }
+
+  const auto is_producer = assign_producers(threads, ratio, options.placement);
+  const auto mix_weight = options.mix.first + options.mix.second;
+
   // pre-allocates a vector for storing the elements enqueued by each thread
   std::vector<std::size_t> thread_ids{};
   thread_ids.reserve(threads);
@@ -448,14 +1423,26 @@ void bench_reads_or_writes(
     thread_ids.push_back(thread);
   }
 
+  // pre-allocates each thread's enqueue and dequeue latency histograms, which
+  // are only recorded into if enabled
+  std::vector<bench::histogram> enq_hists(threads), deq_hists(threads);
+
   // execute benchmark for `runs` iterations
   for (auto run = 0; run < runs; ++run) {
+    alloc::begin_run();
     auto queue = std::make_unique<Q>();
-    boost::barrier barrier{ static_cast<unsigned>(threads + 1) };
+    bench::spin_barrier barrier{ threads + 1 };
+
+    run_control ctrl{ options, threads };
+    const auto ops_limit = ctrl.ops_limit(ops_per_thread);
 
-    // pre-allocates a vector for storing each thread's join handle
-    std::vector<std::thread> thread_handles{};
-    thread_handles.reserve(threads);
+    for (auto thread = 0; thread < threads; ++thread) {
+      enq_hists[thread].reset();
+      deq_hists[thread].reset();
+    }
+
+    // runs each thread on the persistent worker with the same id
+    auto& workers = bench::worker_pool::shared();
 
     // for read-heavy benchmarks, seed the queue with large number of values
     // before starting the benchmark
@@ -468,84 +1455,1428 @@ void bench_reads_or_writes(
 
     // spawns threads and performs the required operations
     for (auto thread = 0; thread < threads; ++thread) {
-      thread_handles.emplace_back(std::thread([&, thread] {
-        bench::pin_current_thread(thread);
-
+      workers.spawn(thread, [&, thread] {
         auto&& queue_ref = make_queue_ref(*queue, thread);
+        bench::think_time think{ options.think, static_cast<std::size_t>(thread) };
 
-        const auto writer_thread = [&]() {
-          for (auto op = 0; op < ops_per_thread; ++op) {
-            queue_ref.enqueue(&thread_ids.at(thread));
+        const auto enqueue = [&](auto& timer) {
+          const auto op_start = timer.start();
+          queue_ref.enqueue(&thread_ids.at(thread));
+          timer.stop(enq_hists[thread], op_start);
+        };
+
+        std::size_t empty_deqs = 0;
+        const auto dequeue = [&](auto& timer) {
+          const auto op_start = timer.start();
+          auto elem = queue_ref.dequeue();
+          timer.stop(deq_hists[thread], op_start);
+          if (elem == nullptr) {
+            empty_deqs += 1;
+            bench::spin_for_ns(50);
+          } else {
+            if (elem < &thread_ids.front() || elem > &thread_ids.back()) {
+              throw std::runtime_error(
+                  "invalid element retrieved (undefined behaviour detected)"
+              );
+            }
           }
         };
 
-        const auto reader_thread = [&]() {
-          for (auto op = 0; op < ops_per_thread; ++op) {
-            auto elem = queue_ref.dequeue();
-            if (elem == nullptr) {
-              bench::spin_for_ns(50);
-            } else {
-              if (elem < &thread_ids.front() || elem > &thread_ids.back()) {
-                throw std::runtime_error(
-                    "invalid element retrieved (undefined behaviour detected)"
-                );
+        // performs all operations, each an enqueue if `next_is_enqueue` says so
+        const auto run_ops = [&](auto&& next_is_enqueue) {
+          bench::with_op_timer(options.latency_interval, [&](auto timer) {
+            std::size_t op = 0;
+            for (; ctrl.proceed(op, ops_limit); ++op) {
+              if (next_is_enqueue()) {
+                enqueue(timer);
+              } else {
+                dequeue(timer);
               }
+
+              think.pause();
             }
-          }
+
+            ctrl.record_ops(thread, op, empty_deqs);
+          });
         };
 
+        ctrl.prepare_thread(thread);
+
         // all threads synchronize at this barrier before starting
         barrier.wait();
-
-        switch (bench_type) {
-          case bench::bench_type_t::WRITES:
-            if (thread % 4 == 0) {
-              reader_thread();
-            } else {
-              writer_thread();
-            }
-            break;
-          case bench::bench_type_t::READS:
-            if (thread % 4 == 0) {
-              writer_thread();
-            } else {
-              reader_thread();
-            }
-            break;
-          case bench::bench_type_t::MIXED:
-            if (thread % 2 == 0) {
-              writer_thread();
-            } else {
-              reader_thread();
-            }
-            break;
-          default: throw std::runtime_error("unreachable branch");
+        ctrl.start_thread(thread);
+
+        if (mix_weight != 0) {
+          std::minstd_rand rng{ static_cast<std::minstd_rand::result_type>(thread + 1) };
+          run_ops([&] { return rng() % mix_weight < options.mix.first; });
+        } else if (is_producer[thread]) {
+          run_ops([] { return true; });
+        } else {
+          run_ops([] { return false; });
         }
 
         // all threads synchronize at this barrier before finishing
         barrier.wait();
-      }));
+      });
     }
 
     // synchronize with threads before starting
     barrier.wait();
     // measures total time once all threads have arrived at the barrier
     const auto start = std::chrono::high_resolution_clock::now();
+    ctrl.await_end();
     // synchronize with threads after finishing
     barrier.wait();
     const auto stop = std::chrono::high_resolution_clock::now();
     const auto duration = stop - start;
 
-    // joins all threads
-    for (auto& handle : thread_handles) {
-      handle.join();
+    // waits for all workers to complete their jobs
+    workers.join_all();
+
+    // print measurements to stdout
+    std::cout
+        << queue_name
+        << "," << threads
+        << "," << duration.count()
+        << "," << ctrl.total_ops(total_ops);
+    if (options.latency_interval != 0) {
+      print_latencies(enq_hists, deq_hists);
+    }
+
+    ctrl.print_thread_ops(duration, ctrl.total_ops(total_ops));
+
+    std::cout << std::endl;
+  }
+}
+
+template <typename Q, typename R>
+void bench_rank_error(
+    std::string_view        queue_name,
+    std::size_t             total_ops,
+    std::size_t             runs,
+    std::size_t             threads,
+    const bench::options_t& options,
+    make_queue_ref_fn<Q, R> make_queue_ref
+) {
+  const auto ops_per_threads = total_ops / threads;
+  const auto enqs_per_thread = (ops_per_threads + 1) / 2;
+
+  // pre-allocates one element per enqueue, each element stores the global
+  // rank at which it was enqueued
+  std::vector<std::size_t> elements(threads * enqs_per_thread);
+
+  // execute benchmark for `runs` iterations
+  for (auto run = 0; run < runs; ++run) {
+    alloc::begin_run();
+    auto queue = std::make_unique<Q>();
+    bench::spin_barrier barrier{ threads + 1 };
+
+    // the global enqueue and dequeue ranks, the additional contention on these
+    // counters is the same for all queues
+    std::atomic<std::size_t> enq_rank{ 0 };
+    std::atomic<std::size_t> deq_rank{ 0 };
+    run_control ctrl{ options, threads };
+
+    // pre-allocates vectors for storing each thread's rank error statistics
+    std::vector<std::size_t> error_sums(threads, 0);
+    std::vector<std::size_t> error_maxs(threads, 0);
+    std::vector<std::size_t> dequeues(threads, 0);
+
+    // runs each thread on the persistent worker with the same id
+    auto& workers = bench::worker_pool::shared();
+
+    // spawns threads and performs pairwise enqueue and dequeue operations
+    for (auto thread = 0; thread < threads; ++thread) {
+      workers.spawn(thread, [&, thread] {
+        auto&& queue_ref = make_queue_ref(*queue, thread);
+        bench::think_time think{ options.think, static_cast<std::size_t>(thread) };
+        std::size_t error_sum = 0, error_max = 0, deq_count = 0, empty_deqs = 0;
+
+        ctrl.prepare_thread(thread);
+
+        // all threads synchronize at this barrier before starting
+        barrier.wait();
+        ctrl.start_thread(thread);
+
+        // the preallocated elements also bound the operations in fixed-duration mode
+        std::size_t op = 0;
+        for (; ctrl.proceed(op, ops_per_threads); ++op) {
+          if (op % 2 == 0) {
+            const auto rank = enq_rank.fetch_add(1, std::memory_order_relaxed);
+            elements[rank] = rank;
+            queue_ref.enqueue(&elements[rank]);
+          } else {
+            auto elem = queue_ref.dequeue();
+            if (elem == nullptr) {
+              empty_deqs += 1;
+              think.pause();
+              continue;
+            }
+
+            if (elem < &elements.front() || elem > &elements.back()) {
+              throw std::runtime_error(
+                  "invalid element retrieved (undefined behaviour detected)"
+              );
+            }
+
+            const auto rank = deq_rank.fetch_add(1, std::memory_order_relaxed);
+            const auto error = *elem > rank ? *elem - rank : rank - *elem;
+            error_sum += error;
+            error_max = std::max(error_max, error);
+            deq_count += 1;
+          }
+
+          think.pause();
+        }
+
+        ctrl.record_ops(thread, op, empty_deqs);
+
+        // all threads synchronize at this barrier before completing
+        barrier.wait();
+
+        error_sums[thread] = error_sum;
+        error_maxs[thread] = error_max;
+        dequeues[thread]   = deq_count;
+      });
     }
 
+    barrier.wait();
+    // measures total time once all threads have arrived at the barrier
+    const auto start = std::chrono::high_resolution_clock::now();
+    ctrl.await_end();
+    barrier.wait();
+    const auto stop = std::chrono::high_resolution_clock::now();
+    const auto duration = stop - start;
+
+    // waits for all workers to complete their jobs
+    workers.join_all();
+
+    const auto error_sum = std::accumulate(error_sums.begin(), error_sums.end(), std::size_t{ 0 });
+    const auto error_max = *std::max_element(error_maxs.begin(), error_maxs.end());
+    const auto deq_count = std::accumulate(dequeues.begin(), dequeues.end(), std::size_t{ 0 });
+    const auto error_mean = deq_count == 0 ? 0.0 : static_cast<double>(error_sum) / deq_count;
+
     // print measurements to stdout
+    // note that the ranks are taken separately from (and before) the
+    // operations, so concurrent threads can take their ranks in a different
+    // order than their operations take effect: the errors have a floor, which
+    // grows with the thread count and is nonzero for strict FIFO queues as
+    // well, so only their difference to a strict FIFO queue (e.g., faa) with
+    // the same thread count reflects a queue's relaxation
+    std::cout
+        << queue_name
+        << "," << threads
+        << "," << duration.count()
+        << "," << ctrl.total_ops(total_ops)
+        << "," << error_mean
+        << "," << error_max;
+    ctrl.print_thread_ops(duration, ctrl.total_ops(total_ops));
+    std::cout << std::endl;
+  }
+}
+
+template <typename Q, typename R>
+void bench_latency(
+    std::string_view        queue_name,
+    std::size_t             total_ops,
+    std::size_t             runs,
+    std::size_t             threads,
+    const bench::options_t& options,
+    make_queue_ref_fn<Q, R> make_queue_ref
+) {
+  using nanosecs = std::chrono::nanoseconds;
+
+  const auto ops_per_threads = total_ops / threads;
+
+  // pre-allocates a vector for storing the elements enqueued by each thread;
+  std::vector<std::size_t> thread_ids{};
+  thread_ids.reserve(threads);
+  for (auto thread = 0; thread < threads; ++thread) {
+    thread_ids.push_back(thread);
+  }
+
+  // pre-allocates vectors for each thread's enqueue and dequeue latencies (in
+  // nanoseconds), so no allocations occur during the measurement
+  std::vector<std::vector<std::uint32_t>> enq_latencies(threads);
+  std::vector<std::vector<std::uint32_t>> deq_latencies(threads);
+  for (auto thread = 0; thread < threads; ++thread) {
+    enq_latencies[thread].reserve((ops_per_threads + 1) / 2);
+    deq_latencies[thread].reserve(ops_per_threads / 2);
+  }
+
+  // execute benchmark for `runs` iterations
+  for (auto run = 0; run < runs; ++run) {
+    alloc::begin_run();
+    auto queue = std::make_unique<Q>();
+    bench::spin_barrier barrier{ threads + 1 };
+
+    run_control ctrl{ options, threads };
+    for (auto thread = 0; thread < threads; ++thread) {
+      enq_latencies[thread].clear();
+      deq_latencies[thread].clear();
+    }
+
+    // runs each thread on the persistent worker with the same id
+    auto& workers = bench::worker_pool::shared();
+
+    // spawns threads and performs pairwise enqueue and dequeue operations
+    for (auto thread = 0; thread < threads; ++thread) {
+      workers.spawn(thread, [&, thread] {
+        auto&& queue_ref = make_queue_ref(*queue, thread);
+        bench::think_time think{ options.think, static_cast<std::size_t>(thread) };
+        auto& enq_lat = enq_latencies[thread];
+        auto& deq_lat = deq_latencies[thread];
+
+        ctrl.prepare_thread(thread);
+
+        // all threads synchronize at this barrier before starting
+        barrier.wait();
+        ctrl.start_thread(thread);
+
+        // the preallocated samples also bound the operations in fixed-duration mode
+        std::size_t op = 0, empty_deqs = 0;
+        for (; ctrl.proceed(op, ops_per_threads); ++op) {
+          const auto op_start = std::chrono::steady_clock::now();
+          if (op % 2 == 0) {
+            queue_ref.enqueue(&thread_ids.at(thread));
+            const nanosecs lat = std::chrono::steady_clock::now() - op_start;
+            enq_lat.push_back(static_cast<std::uint32_t>(
+                std::min<std::int64_t>(lat.count(), UINT32_MAX)
+            ));
+          } else {
+            auto elem = queue_ref.dequeue();
+            const nanosecs lat = std::chrono::steady_clock::now() - op_start;
+            deq_lat.push_back(static_cast<std::uint32_t>(
+                std::min<std::int64_t>(lat.count(), UINT32_MAX)
+            ));
+
+            if (elem == nullptr) {
+              empty_deqs += 1;
+            } else if (elem < &thread_ids.front() || elem > &thread_ids.back()) {
+              throw std::runtime_error(
+                  "invalid element retrieved (undefined behaviour detected)"
+              );
+            }
+          }
+
+          think.pause();
+        }
+
+        ctrl.record_ops(thread, op, empty_deqs);
+
+        // all threads synchronize at this barrier before completing
+        barrier.wait();
+      });
+    }
+
+    barrier.wait();
+    // measures total time once all threads have arrived at the barrier
+    const auto start = std::chrono::high_resolution_clock::now();
+    ctrl.await_end();
+    barrier.wait();
+    const auto stop = std::chrono::high_resolution_clock::now();
+    const auto duration = stop - start;
+
+    // waits for all workers to complete their jobs
+    workers.join_all();
+
+    // merges all per-thread samples
+    std::vector<std::uint32_t> enq_samples{}, deq_samples{};
+    for (auto thread = 0; thread < threads; ++thread) {
+      enq_samples.insert(enq_samples.end(), enq_latencies[thread].begin(), enq_latencies[thread].end());
+      deq_samples.insert(deq_samples.end(), deq_latencies[thread].begin(), deq_latencies[thread].end());
+    }
+
+    // print measurements to stdout (latencies in nanoseconds)
     std::cout
         << queue_name
         << "," << threads
         << "," << duration.count()
-        << "," << total_ops << std::endl;
+        << "," << ctrl.total_ops(total_ops)
+        << "," << sample_percentile(enq_samples, 99.99)
+        << "," << sample_percentile(enq_samples, 100.0)
+        << "," << sample_percentile(deq_samples, 99.99)
+        << "," << sample_percentile(deq_samples, 100.0);
+    ctrl.print_thread_ops(duration, ctrl.total_ops(total_ops));
+    std::cout << std::endl;
+  }
+}
+
+template <typename Q, typename R>
+void bench_approx_size(
+    std::string_view        queue_name,
+    std::size_t             total_ops,
+    std::size_t             runs,
+    std::size_t             threads,
+    const bench::options_t& options,
+    make_queue_ref_fn<Q, R> make_queue_ref
+) {
+  if constexpr (!SizedQueue<Q>) {
+    throw std::invalid_argument("queue does not support the 'size' bench");
+  } else {
+    const auto ops_per_thread = total_ops / threads;
+    // the sampling thread uses the first thread id after all worker threads
+    const auto sampler = threads;
+
+    // pre-allocates enough elements for each thread to only enqueue
+    std::vector<std::size_t> elements(threads * ops_per_thread);
+
+    // execute benchmark for `runs` iterations
+    for (auto run = 0; run < runs; ++run) {
+      alloc::begin_run();
+      auto queue = std::make_unique<Q>();
+      bench::spin_barrier barrier{ threads + 2 };
+      // the sampler does not wait at the stop barrier
+      bench::spin_barrier stop_barrier{ threads + 1 };
+
+      // the exact number of elements, which is only maintained in this bench
+      // and by the worker threads, so its cost is the same for all queues
+      std::atomic<std::int64_t> exact_size{ 0 };
+      std::atomic<bool> done{ false };
+      run_control ctrl{ options, threads };
+
+      std::size_t samples = 0;
+      double error_sum = 0.0, size_sum = 0.0;
+      std::chrono::nanoseconds sample_time{ 0 };
+
+      // runs each thread on the persistent worker with the same id
+      auto& workers = bench::worker_pool::shared();
+
+      // spawns threads, which first mostly enqueue and then mostly dequeue, so
+      // the queue grows and shrinks over several nodes
+      for (auto thread = 0; thread < threads; ++thread) {
+        workers.spawn(thread, [&, thread] {
+          auto&& queue_ref = make_queue_ref(*queue, thread);
+          std::minstd_rand rng{ static_cast<std::minstd_rand::result_type>(thread + 1) };
+          bench::think_time think{ options.think, static_cast<std::size_t>(thread) };
+          const auto thread_elements = &elements[thread * ops_per_thread];
+          std::size_t enqueued = 0;
+
+          ctrl.prepare_thread(thread);
+
+          // all threads synchronize at this barrier before starting
+          barrier.wait();
+          ctrl.start_thread(thread);
+
+          // the preallocated elements also bound the operations in
+          // fixed-duration mode
+          std::size_t op = 0, empty_deqs = 0;
+          for (; ctrl.proceed(op, ops_per_thread); ++op) {
+            const auto enqueue_pct = ctrl.second_half(op, ops_per_thread) ? 25 : 75;
+            if (rng() % 100 < enqueue_pct) {
+              queue_ref.enqueue(&thread_elements[enqueued++]);
+              exact_size.fetch_add(1, std::memory_order_relaxed);
+            } else if (queue_ref.dequeue() != nullptr) {
+              exact_size.fetch_sub(1, std::memory_order_relaxed);
+            } else {
+              empty_deqs += 1;
+            }
+
+            think.pause();
+          }
+
+          ctrl.record_ops(thread, op, empty_deqs);
+
+          // all worker threads synchronize at this barrier before completing
+          stop_barrier.wait();
+        });
+      }
+
+      workers.spawn(sampler, [&] {
+        barrier.wait();
+
+        while (!done.load(std::memory_order_relaxed)) {
+          const auto exact = std::max<std::int64_t>(exact_size.load(std::memory_order_relaxed), 0);
+          const auto start = std::chrono::steady_clock::now();
+          const auto approx = queue->approx_size(sampler);
+          const auto stop = std::chrono::steady_clock::now();
+
+          sample_time += stop - start;
+          const auto diff = static_cast<double>(approx) - static_cast<double>(exact);
+          error_sum += diff < 0.0 ? -diff : diff;
+          size_sum += static_cast<double>(exact);
+          samples += 1;
+        }
+      });
+
+      barrier.wait();
+      // measures total time once all threads have arrived at the barrier, the
+      // sampler runs until all worker threads have completed
+      const auto start = std::chrono::high_resolution_clock::now();
+      ctrl.await_end();
+      stop_barrier.wait();
+      const auto stop = std::chrono::high_resolution_clock::now();
+      const auto duration = stop - start;
+
+      done.store(true, std::memory_order_relaxed);
+      workers.join_all();
+
+      const auto divisor = static_cast<double>(std::max<std::size_t>(samples, 1));
+
+      // print measurements to stdout
+      std::cout
+          << queue_name
+          << "," << threads
+          << "," << duration.count()
+          << "," << ctrl.total_ops(total_ops)
+          << "," << static_cast<double>(sample_time.count()) / divisor
+          << "," << error_sum / divisor
+          << "," << size_sum / divisor
+          << "," << samples;
+      ctrl.print_thread_ops(duration, ctrl.total_ops(total_ops));
+      std::cout << std::endl;
+    }
+  }
+}
+
+template <typename Q, typename R>
+void bench_producers_consumers(
+    std::string_view        queue_name,
+    std::size_t             total_ops,
+    std::size_t             runs,
+    std::size_t             producers,
+    std::size_t             consumers,
+    std::size_t             batch_size,
+    const bench::options_t& options,
+    make_queue_ref_fn<Q, R> make_queue_ref
+) {
+  // half of all operations are enqueues, the other half dequeues
+  const auto threads = producers + consumers;
+  const auto enqs_per_producer = (total_ops / 2) / producers;
+  const auto total_enqs = enqs_per_producer * producers;
+
+  // pre-allocates a vector for storing the elements enqueued by each thread
+  std::vector<std::size_t> thread_ids{};
+  thread_ids.reserve(threads);
+  for (auto thread = 0; thread < threads; ++thread) {
+    thread_ids.push_back(thread);
+  }
+
+  // pre-allocates one batch of the producer's own element per producer, so
+  // no allocation falls into the measurement
+  std::vector<std::vector<std::size_t*>> batches{};
+  if (batch_size != 0) {
+    batches.reserve(producers);
+    for (auto producer = 0; producer < producers; ++producer) {
+      batches.emplace_back(batch_size, &thread_ids.at(producer));
+    }
+  }
+
+  // execute benchmark for `runs` iterations
+  for (auto run = 0; run < runs; ++run) {
+    alloc::begin_run();
+    auto queue = std::make_unique<Q>();
+    bench::spin_barrier barrier{ threads + 1 };
+    run_control ctrl{ options, threads };
+    const auto enqs_limit = ctrl.ops_limit(enqs_per_producer);
+
+    // runs each thread on the persistent worker with the same id
+    auto& workers = bench::worker_pool::shared();
+
+    // spawns the producer threads (ids 0 to producers - 1) and the consumer
+    // threads, which dequeue until all enqueued elements have been retrieved
+    for (auto thread = 0; thread < threads; ++thread) {
+      workers.spawn(thread, [&, thread] {
+        auto&& queue_ref = make_queue_ref(*queue, thread);
+        bench::think_time think{ options.think, static_cast<std::size_t>(thread) };
+
+        ctrl.prepare_thread(thread);
+
+        // all threads synchronize at this barrier before starting
+        barrier.wait();
+        ctrl.start_thread(thread);
+
+        if (thread < producers && batch_size == 0) {
+          std::size_t op = 0;
+          for (; ctrl.proceed(op, enqs_limit); ++op) {
+            queue_ref.enqueue(&thread_ids.at(thread));
+            think.pause();
+          }
+
+          ctrl.record_ops(thread, op);
+        } else if (thread < producers) {
+          const auto& batch = batches[thread];
+          std::size_t op = 0;
+          while (ctrl.proceed(op, enqs_limit)) {
+            const auto count = std::min(batch_size, enqs_limit - op);
+            enqueue_batch<Q, R>(*queue, queue_ref, std::span(batch.data(), count), thread);
+            op += count;
+            think.pause();
+          }
+
+          ctrl.record_ops(thread, op);
+        } else {
+          // the first consumer also dequeues the remainder, in fixed-duration
+          // mode, all consumers instead dequeue until the time is up
+          const auto consumer = thread - producers;
+          auto deqs = total_enqs / consumers;
+          if (consumer == 0) {
+            deqs += total_enqs % consumers;
+          }
+
+          // consumers only think after retrieving an element, not while
+          // polling the empty queue
+          std::size_t dequeued = 0, empty_deqs = 0;
+          while (ctrl.timed() ? ctrl.running() : dequeued < deqs) {
+            auto elem = queue_ref.dequeue();
+            if (elem == nullptr) {
+              empty_deqs += 1;
+              continue;
+            }
+
+            if (elem < &thread_ids.front() || elem > &thread_ids.back()) {
+              throw std::runtime_error(
+                  "invalid element retrieved (undefined behaviour detected)"
+              );
+            }
+
+            dequeued += 1;
+            think.pause();
+          }
+
+          ctrl.record_ops(thread, dequeued, empty_deqs);
+        }
+
+        // all threads synchronize at this barrier before completing
+        barrier.wait();
+      });
+    }
+
+    barrier.wait();
+    // measures total time once all threads have arrived at the barrier
+    const auto start = std::chrono::high_resolution_clock::now();
+    ctrl.await_end();
+    barrier.wait();
+    const auto stop = std::chrono::high_resolution_clock::now();
+    const auto duration = stop - start;
+
+    // waits for all workers to complete their jobs
+    workers.join_all();
+
+    // print measurements to stdout
+    std::cout
+        << queue_name
+        << "," << threads
+        << "," << duration.count()
+        << "," << ctrl.total_ops(2 * total_enqs);
+    ctrl.print_thread_ops(duration, ctrl.total_ops(2 * total_enqs));
+    std::cout << std::endl;
+  }
+}
+
+template <typename Q>
+void bench_notify(
+    std::string_view        queue_name,
+    std::size_t             total_ops,
+    std::size_t             runs,
+    std::size_t             producers,
+    const bench::options_t& options
+) {
+  if constexpr (!ThreadIdQueue<Q>) {
+    throw std::invalid_argument("queue does not support the 'notify' bench");
+  } else {
+    using nanosecs = std::chrono::nanoseconds;
+    using pointer  = typename Q::pointer;
+
+    const auto enqs_per_producer = total_ops / 2 / producers;
+    const auto messages = enqs_per_producer * producers;
+    // the consumer uses the first thread id after all producer threads
+    const auto consumer = producers;
+
+    // each element stores the index of its message, so the consumer can look
+    // up the time at which it was sent
+    std::vector<std::size_t> elements(messages);
+    std::iota(elements.begin(), elements.end(), std::size_t{ 0 });
+    std::vector<std::chrono::steady_clock::time_point> send_times(messages);
+    std::vector<std::uint32_t> latencies{};
+    latencies.reserve(messages);
+
+    // execute benchmark for `runs` iterations, each with both consumer modes
+    for (auto run = 0; run < runs; ++run) {
+      for (const auto use_epoll : { true, false }) {
+        alloc::begin_run();
+        auto queue = std::make_unique<evt::queue<Q>>();
+        bench::spin_barrier barrier{ producers + 2 };
+        std::size_t consumer_syscalls = 0;
+        latencies.clear();
+
+        // runs each thread on the persistent worker with the same id
+        auto& workers = bench::worker_pool::shared();
+
+        for (auto thread = 0; thread < producers; ++thread) {
+          workers.spawn(thread, [&, thread] {
+            bench::think_time think{ options.think, static_cast<std::size_t>(thread) };
+
+            // all threads synchronize at this barrier before starting
+            barrier.wait();
+
+            for (auto op = 0; op < enqs_per_producer; ++op) {
+              const auto idx = thread * enqs_per_producer + op;
+              send_times[idx] = std::chrono::steady_clock::now();
+              queue->enqueue(&elements[idx], thread);
+              bench::spin_for_ns(NOTIFY_DELAY_NS);
+              think.pause();
+            }
+
+            // all threads synchronize at this barrier before completing
+            barrier.wait();
+          });
+        }
+
+        workers.spawn(consumer, [&] {
+          const auto receive = [&](pointer elem) {
+            if (elem < &elements.front() || elem > &elements.back()) {
+              throw std::runtime_error("invalid element retrieved (undefined behaviour detected)");
+            }
+
+            const nanosecs lat = std::chrono::steady_clock::now() - send_times[*elem];
+            latencies.push_back(static_cast<std::uint32_t>(
+                std::min<std::int64_t>(lat.count(), UINT32_MAX)
+            ));
+          };
+
+          const auto epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+          epoll_event event{ .events = EPOLLIN, .data = { .fd = queue->fd() } };
+          if (epoll_fd == -1 || ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, queue->fd(), &event) == -1) {
+            throw std::system_error(errno, std::generic_category(), "failed to set up epoll");
+          }
+
+          std::array<pointer, NOTIFY_BATCH_SIZE> batch{};
+
+          // all threads synchronize at this barrier before starting
+          barrier.wait();
+
+          while (latencies.size() < messages) {
+            if (!use_epoll) {
+              // same as the reader in `bench_reads_or_writes`
+              const auto elem = queue->dequeue(consumer);
+              if (elem == nullptr) {
+                bench::spin_for_ns(50);
+              } else {
+                receive(elem);
+              }
+
+              continue;
+            }
+
+            const auto count = queue->dequeue_batch(batch, consumer);
+            for (std::size_t i = 0; i < count; ++i) {
+              receive(batch[i]);
+            }
+
+            if (count > 0) {
+              continue;
+            }
+
+            if (const auto elem = queue->arm(consumer); elem != nullptr) {
+              receive(elem);
+              continue;
+            }
+
+            while (::epoll_wait(epoll_fd, &event, 1, -1) == -1) {
+              if (errno != EINTR) {
+                throw std::system_error(errno, std::generic_category(), "failed to wait for epoll");
+              }
+            }
+
+            queue->clear();
+            consumer_syscalls += 2;
+          }
+
+          // all threads synchronize at this barrier before completing
+          barrier.wait();
+          ::close(epoll_fd);
+        });
+
+        barrier.wait();
+        // measures total time once all threads have arrived at the barrier
+        const auto start = std::chrono::high_resolution_clock::now();
+        barrier.wait();
+        const auto stop = std::chrono::high_resolution_clock::now();
+        const auto duration = stop - start;
+
+        // waits for all workers to complete their jobs
+        workers.join_all();
+
+        const auto syscalls = consumer_syscalls + queue->signals();
+        const auto latency_sum = std::accumulate(latencies.begin(), latencies.end(), 0.0);
+
+        // print measurements to stdout (latencies in nanoseconds)
+        std::cout
+            << queue_name
+            << "," << producers + 1
+            << "," << duration.count()
+            << "," << total_ops
+            << "," << (use_epoll ? "epoll" : "poll")
+            << "," << static_cast<double>(syscalls) / messages
+            << "," << latency_sum / messages
+            << "," << sample_percentile(latencies, 99.0);
+        events::print_totals(std::cout);
+        alloc::print_totals(std::cout, total_ops);
+        std::cout << std::endl;
+      }
+    }
+  }
+}
+
+template <typename Q>
+void bench_async(
+    std::string_view        queue_name,
+    std::size_t             total_ops,
+    std::size_t             runs,
+    std::size_t             threads,
+    const bench::options_t& options
+) {
+  if constexpr (!ThreadIdQueue<Q>) {
+    throw std::invalid_argument("queue does not support the 'async' bench");
+  } else {
+    using pointer = typename Q::pointer;
+    using clock   = std::chrono::high_resolution_clock;
+
+    const auto producers = threads / 2;
+    const auto consumers = threads - producers;
+    const auto enqs_per_producer = total_ops / 2 / producers;
+    const auto messages = enqs_per_producer * producers;
+
+    // each consumer dequeues an equal share, the last one also the remainder
+    const auto deqs_of_consumer = [&](std::size_t consumer) {
+      const auto share = messages / consumers;
+      return consumer == consumers - 1 ? messages - share * (consumers - 1) : share;
+    };
+
+    std::vector<std::size_t> elements(messages);
+    std::iota(elements.begin(), elements.end(), std::size_t{ 0 });
+
+    const auto check_elem = [&](pointer elem) {
+      if (elem < &elements.front() || elem > &elements.back()) {
+        throw std::runtime_error("invalid element retrieved (undefined behaviour detected)");
+      }
+    };
+
+    // prints one line of measurements to stdout
+    const auto print = [&](std::string_view mode, clock::duration duration) {
+      std::cout
+          << queue_name
+          << "," << threads
+          << "," << duration.count()
+          << "," << total_ops
+          << "," << mode
+          << "," << static_cast<double>(duration.count()) / messages;
+      events::print_totals(std::cout);
+      alloc::print_totals(std::cout, total_ops);
+      std::cout << std::endl;
+    };
+
+    // each task thinks with the PRNG of the thread with the same role in the
+    // plain mode
+    const auto producer_task = [&](auto& executor, coro::queue<Q>& queue, std::size_t producer) -> coro::task {
+      bench::think_time think{ options.think, producer };
+      const auto& thread_id = co_await coro::this_thread_id();
+      for (auto op = 0; op < enqs_per_producer; ++op) {
+        queue.push(&elements[producer * enqs_per_producer + op], thread_id);
+        think.pause();
+        if (op % ASYNC_YIELD_INTERVAL == ASYNC_YIELD_INTERVAL - 1) {
+          co_await executor.yield();
+        }
+      }
+    };
+
+    const auto consumer_task = [&](coro::queue<Q>& queue, std::size_t consumer) -> coro::task {
+      bench::think_time think{ options.think, producers + consumer };
+      const auto& thread_id = co_await coro::this_thread_id();
+      for (auto op = 0; op < deqs_of_consumer(consumer); ++op) {
+        check_elem(co_await queue.pop(thread_id));
+        think.pause();
+      }
+    };
+
+    // spawns all consumer tasks first, so they start out waiting
+    const auto spawn_tasks = [&](auto& executor, coro::queue<Q>& queue) {
+      for (std::size_t consumer = 0; consumer < consumers; ++consumer) {
+        executor.spawn(consumer_task(queue, consumer));
+      }
+
+      for (std::size_t producer = 0; producer < producers; ++producer) {
+        executor.spawn(producer_task(executor, queue, producer));
+      }
+    };
+
+    // execute benchmark for `runs` iterations, each with all three modes
+    for (auto run = 0; run < runs; ++run) {
+      {
+        // dedicated producer and consumer threads with the plain `queue_ref`
+        alloc::begin_run();
+        auto queue = std::make_unique<Q>();
+        bench::spin_barrier barrier{ threads + 1 };
+
+        // runs each thread on the persistent worker with the same id
+        auto& workers = bench::worker_pool::shared();
+        for (auto thread = 0; thread < threads; ++thread) {
+          workers.spawn(thread, [&, thread] {
+            auto queue_ref = ::queue_ref<Q>(*queue, thread);
+            bench::think_time think{ options.think, static_cast<std::size_t>(thread) };
+
+            // all threads synchronize at this barrier before starting
+            barrier.wait();
+
+            if (thread < producers) {
+              for (auto op = 0; op < enqs_per_producer; ++op) {
+                queue_ref.enqueue(&elements[thread * enqs_per_producer + op]);
+                think.pause();
+              }
+            } else {
+              for (auto op = 0; op < deqs_of_consumer(thread - producers); ++op) {
+                pointer elem;
+                while ((elem = queue_ref.dequeue()) == nullptr) {}
+                check_elem(elem);
+                think.pause();
+              }
+            }
+
+            // all threads synchronize at this barrier before completing
+            barrier.wait();
+          });
+        }
+
+        barrier.wait();
+        const auto start = clock::now();
+        barrier.wait();
+        const auto stop = clock::now();
+
+        // waits for all workers to complete their jobs
+        workers.join_all();
+
+        print("plain", stop - start);
+      }
+
+      {
+        // all tasks on one executor thread
+        alloc::begin_run();
+        auto queue = std::make_unique<coro::queue<Q>>();
+        coro::single_thread_executor executor{};
+        spawn_tasks(executor, *queue);
+
+        // the executor runs on the persistent worker 0
+        auto& workers = bench::worker_pool::shared();
+        const auto start = clock::now();
+        workers.spawn(0, [&] { executor.run(); });
+        workers.join(0);
+        const auto stop = clock::now();
+
+        if (executor.pending() != 0) {
+          throw std::runtime_error("single-threaded executor stalled with pending tasks");
+        }
+
+        print("async_st", stop - start);
+      }
+
+      {
+        // all tasks on a pool of `threads` executor threads
+        alloc::begin_run();
+        auto queue = std::make_unique<coro::queue<Q>>();
+        coro::thread_pool_executor executor{ threads };
+        spawn_tasks(executor, *queue);
+        bench::spin_barrier barrier{ threads + 1 };
+
+        // each executor thread runs on the persistent worker with the same id
+        auto& workers = bench::worker_pool::shared();
+        for (std::size_t thread = 0; thread < threads; ++thread) {
+          workers.spawn(thread, [&, thread] {
+            barrier.wait();
+            executor.run(thread);
+            barrier.wait();
+          });
+        }
+
+        barrier.wait();
+        const auto start = clock::now();
+        barrier.wait();
+        const auto stop = clock::now();
+
+        // waits for all workers to complete their jobs
+        workers.join_all();
+
+        print("async_mt", stop - start);
+      }
+    }
+  }
+}
+
+template <typename Q, typename R>
+void bench_fork_join(
+    std::string_view        queue_name,
+    std::size_t             runs,
+    std::size_t             threads,
+    const bench::options_t& options,
+    make_queue_ref_fn<Q, R> make_queue_ref
+) {
+  constexpr auto workloads = std::to_array({
+      sched::workload_t::FIB, sched::workload_t::NQUEENS, sched::workload_t::TREE
+  });
+  constexpr auto modes = std::to_array({ sched::mode_t::SHARED, sched::mode_t::STEALING });
+
+  // the sequential results are computed once, outside of any measurement
+  std::array<std::uint64_t, workloads.size()> expected{};
+  for (std::size_t idx = 0; idx < workloads.size(); ++idx) {
+    expected[idx] = sched::expected_result(workloads[idx]);
+  }
+
+  // execute benchmark for `runs` iterations, each with all workloads and modes
+  for (auto run = 0; run < runs; ++run) {
+    for (std::size_t idx = 0; idx < workloads.size(); ++idx) {
+      for (const auto mode : modes) {
+        alloc::begin_run();
+        auto queue = std::make_unique<Q>();
+        sched::fork_join_pool pool{ threads, mode };
+        bench::spin_barrier barrier{ threads + 1 };
+
+        {
+          auto&& injector = make_queue_ref(*queue, 0);
+          pool.inject(injector, sched::make_root_job(workloads[idx]));
+        }
+
+        // runs each thread on the persistent worker with the same id
+        auto& workers = bench::worker_pool::shared();
+        for (auto thread = 0; thread < threads; ++thread) {
+          workers.spawn(thread, [&, thread] {
+            auto&& queue_ref = make_queue_ref(*queue, thread);
+            bench::think_time think{ options.think, static_cast<std::size_t>(thread) };
+
+            // all threads synchronize at this barrier before starting
+            barrier.wait();
+            pool.work(queue_ref, thread, [&] { think.pause(); });
+            // all threads synchronize at this barrier before completing
+            barrier.wait();
+          });
+        }
+
+        barrier.wait();
+        const auto start = std::chrono::high_resolution_clock::now();
+        barrier.wait();
+        const auto stop = std::chrono::high_resolution_clock::now();
+        const auto duration = stop - start;
+
+        // waits for all workers to complete their jobs
+        workers.join_all();
+
+        if (pool.result() != expected[idx]) {
+          throw std::runtime_error("fork-join result differs from sequential result");
+        }
+
+        // print measurements to stdout, with the number of executed jobs in
+        // place of the total number of operations
+        const auto stats = pool.stats();
+        std::cout
+            << queue_name
+            << "," << threads
+            << "," << duration.count()
+            << "," << stats.executed
+            << "," << sched::display_str(workloads[idx])
+            << "," << sched::display_str(mode)
+            << "," << stats.steals
+            << "," << stats.overflows;
+        events::print_totals(std::cout);
+        alloc::print_totals(std::cout, stats.executed);
+        std::cout << std::endl;
+      }
+    }
+  }
+}
+
+template <typename Q, typename R>
+void bench_pipeline(
+    std::string_view                         queue_name,
+    std::size_t                              total_ops,
+    std::size_t                              runs,
+    std::span<const bench::pipeline_stage_t> stages,
+    const bench::options_t&                  options,
+    make_queue_ref_fn<Q, R>                  make_queue_ref
+) {
+  /** number of elements a thread has passed on so far, only written by itself */
+  struct alignas(CACHE_LINE_ALIGN) progress_t {
+    std::atomic<std::size_t> processed{ 0 };
+  };
+
+  const auto hops = stages.size() - 1;
+  const auto producers = stages.front().threads;
+  const auto enqs_per_producer = total_ops / 2 / producers;
+  const auto messages = enqs_per_producer * producers;
+
+  // threads are numbered consecutively across all stages, the sampling thread
+  // uses the first thread id after all stage threads
+  std::vector<std::size_t> first_thread_ids{};
+  std::size_t threads = 0;
+  std::string stages_str{};
+  for (const auto& stage : stages) {
+    first_thread_ids.push_back(threads);
+    threads += stage.threads;
+
+    stages_str += stages_str.empty() ? "" : "/";
+    stages_str += std::to_string(stage.threads) + ":" + std::to_string(stage.work_ns);
+  }
+
+  const auto sampler = threads;
+
+  std::vector<std::size_t> elements(messages);
+  const auto check_elem = [&](std::size_t* elem) {
+    if (elem < &elements.front() || elem > &elements.back()) {
+      throw std::runtime_error("invalid element retrieved (undefined behaviour detected)");
+    }
+  };
+
+  // execute benchmark for `runs` iterations
+  for (auto run = 0; run < runs; ++run) {
+    alloc::begin_run();
+    std::vector<std::unique_ptr<Q>> queues{};
+    for (std::size_t hop = 0; hop < hops; ++hop) {
+      queues.push_back(std::make_unique<Q>());
+    }
+
+    // the number of threads still enqueueing into each queue, once it drops
+    // to zero, a consumer finding its queue empty can stop
+    const auto active = std::make_unique<std::atomic<std::size_t>[]>(hops);
+    for (std::size_t hop = 0; hop < hops; ++hop) {
+      active[hop].store(stages[hop].threads, std::memory_order_relaxed);
+    }
+
+    std::vector<progress_t> progress(threads);
+    std::atomic<std::size_t> consumed{ 0 };
+    run_control ctrl{ options, threads };
+    const auto enqs_limit = ctrl.ops_limit(enqs_per_producer);
+    std::atomic<bool> done{ false };
+    bench::spin_barrier barrier{ threads + 2 };
+    // the sampler does not wait at the stop barrier
+    bench::spin_barrier stop_barrier{ threads + 1 };
+
+    std::vector<double> occupancy_sums(hops, 0.0);
+    std::vector<std::int64_t> occupancy_max(hops, 0);
+    std::size_t samples = 0;
+
+    // dequeues from the stage's input queue until it is drained for good (or
+    // the time is up) and passes each element on, records and returns the
+    // number of dequeued elements
+    const auto consume = [&](auto& in, std::size_t stage, std::size_t thread, auto&& forward) {
+      bench::think_time think{ options.think, thread };
+      std::size_t processed = 0, empty_deqs = 0;
+      while (ctrl.running()) {
+        auto elem = in.dequeue();
+        if (elem == nullptr) {
+          empty_deqs += 1;
+          if (active[stage - 1].load(std::memory_order_acquire) != 0) {
+            continue;
+          }
+
+          // all upstream threads are done, so an empty queue remains empty
+          if ((elem = in.dequeue()) == nullptr) {
+            break;
+          }
+        }
+
+        check_elem(elem);
+        if (stages[stage].work_ns != 0) {
+          bench::spin_for_ns(stages[stage].work_ns);
+        }
+
+        think.pause();
+
+        forward(elem);
+        progress[thread].processed.store(++processed, std::memory_order_relaxed);
+      }
+
+      ctrl.record_ops(thread, processed, empty_deqs);
+      return processed;
+    };
+
+    // runs each thread on the persistent worker with the same id
+    auto& workers = bench::worker_pool::shared();
+
+    for (std::size_t stage = 0; stage < stages.size(); ++stage) {
+      for (std::size_t idx = 0; idx < stages[stage].threads; ++idx) {
+        const auto thread = first_thread_ids[stage] + idx;
+        workers.spawn(thread, [&, stage, idx, thread] {
+          if (stage == 0) {
+            auto&& out = make_queue_ref(*queues[0], thread);
+            bench::think_time think{ options.think, thread };
+            const auto thread_elements = &elements[idx * enqs_per_producer];
+
+            ctrl.prepare_thread(thread);
+
+            // all threads synchronize at this barrier before starting
+            barrier.wait();
+            ctrl.start_thread(thread);
+
+            // in fixed-duration mode, the producer's elements are reused
+            std::size_t op = 0;
+            for (; ctrl.proceed(op, enqs_limit); ++op) {
+              if (stages[0].work_ns != 0) {
+                bench::spin_for_ns(stages[0].work_ns);
+              }
+
+              think.pause();
+              out.enqueue(&thread_elements[op % enqs_per_producer]);
+              progress[thread].processed.store(op + 1, std::memory_order_relaxed);
+            }
+
+            ctrl.record_ops(thread, op);
+          } else if (stage < hops) {
+            auto&& in = make_queue_ref(*queues[stage - 1], thread);
+            auto&& out = make_queue_ref(*queues[stage], thread);
+            ctrl.prepare_thread(thread);
+            barrier.wait();
+            ctrl.start_thread(thread);
+            consume(in, stage, thread, [&](std::size_t* elem) {
+              out.enqueue(elem);
+            });
+          } else {
+            auto&& in = make_queue_ref(*queues[stage - 1], thread);
+            ctrl.prepare_thread(thread);
+            barrier.wait();
+            ctrl.start_thread(thread);
+            const auto processed = consume(in, stage, thread, [](std::size_t*) {});
+            consumed.fetch_add(processed, std::memory_order_relaxed);
+          }
+
+          if (stage < hops) {
+            active[stage].fetch_sub(1, std::memory_order_release);
+          }
+
+          // all stage threads synchronize at this barrier before completing
+          stop_barrier.wait();
+        });
+      }
+    }
+
+    // samples the number of elements in each queue from the progress of the
+    // threads on either side of it
+    workers.spawn(sampler, [&] {
+      barrier.wait();
+
+      const auto sum_progress = [&](std::size_t stage) {
+        std::int64_t res = 0;
+        for (std::size_t idx = 0; idx < stages[stage].threads; ++idx) {
+          const auto thread = first_thread_ids[stage] + idx;
+          res += static_cast<std::int64_t>(progress[thread].processed.load(std::memory_order_relaxed));
+        }
+
+        return res;
+      };
+
+      while (!done.load(std::memory_order_relaxed)) {
+        for (std::size_t hop = 0; hop < hops; ++hop) {
+          // the consumers' progress is read first, so the result is never
+          // lower than the actual occupancy, except for in-flight elements
+          const auto dequeued = sum_progress(hop + 1);
+          const auto occupancy = std::max<std::int64_t>(sum_progress(hop) - dequeued, 0);
+          occupancy_sums[hop] += static_cast<double>(occupancy);
+          occupancy_max[hop] = std::max(occupancy_max[hop], occupancy);
+        }
+
+        samples += 1;
+        bench::spin_for_ns(PIPELINE_SAMPLE_INTERVAL_NS);
+      }
+    });
+
+    barrier.wait();
+    // measures total time once all threads have arrived at the barrier until
+    // the last element has reached the sink
+    const auto start = std::chrono::high_resolution_clock::now();
+    ctrl.await_end();
+    stop_barrier.wait();
+    const auto stop = std::chrono::high_resolution_clock::now();
+    const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start);
+
+    done.store(true, std::memory_order_relaxed);
+    workers.join_all();
+
+    // in fixed-duration mode, elements still in flight are abandoned
+    const auto total_messages = consumed.load(std::memory_order_relaxed);
+    if (!ctrl.timed() && total_messages != messages) {
+      throw std::runtime_error("pipeline sink did not receive all elements");
+    }
+
+    // the mean and maximum occupancy of each queue, separated by '/'
+    std::string occupancy_str{};
+    const auto divisor = static_cast<double>(std::max<std::size_t>(samples, 1));
+    for (std::size_t hop = 0; hop < hops; ++hop) {
+      occupancy_str += hop == 0 ? "" : "/";
+      occupancy_str += std::to_string(occupancy_sums[hop] / divisor) + ":" + std::to_string(occupancy_max[hop]);
+    }
+
+    // print measurements to stdout
+    std::cout
+        << queue_name
+        << "," << threads
+        << "," << duration.count()
+        << "," << (ctrl.timed() ? 2 * total_messages : total_ops)
+        << "," << stages_str
+        << "," << static_cast<double>(total_messages) * 1e9 / static_cast<double>(std::max<std::int64_t>(duration.count(), 1))
+        << "," << occupancy_str;
+    ctrl.print_thread_ops(duration, ctrl.timed() ? 2 * total_messages : total_ops);
+    std::cout << std::endl;
+  }
+}
+
+template <typename Q, typename R>
+void bench_open_loop(
+    std::string_view        queue_name,
+    std::size_t             total_ops,
+    std::size_t             runs,
+    std::size_t             producers,
+    std::size_t             consumers,
+    const bench::options_t& options,
+    make_queue_ref_fn<Q, R> make_queue_ref
+) {
+  // half of all operations are enqueues, the other half dequeues
+  const auto threads = producers + consumers;
+  const auto enqs_per_producer = (total_ops / 2) / producers;
+  const auto total_enqs = enqs_per_producer * producers;
+  const auto poisson = options.arrival == bench::arrival_t::POISSON;
+
+  // each element points to two slots, into which its producer writes the
+  // element's intended and actual send time (in cycles) before enqueueing it
+  std::vector<std::size_t> slots(2 * total_enqs);
+  const auto check_elem = [&](std::size_t* elem) {
+    if (elem < &slots.front() || elem > &slots.back()) {
+      throw std::runtime_error("invalid element retrieved (undefined behaviour detected)");
+    }
+  };
+
+  // the consumers' latencies measured from each element's intended (corrected
+  // for coordinated omission) and from its actual send time
+  std::vector<bench::histogram> corrected(threads);
+  std::vector<bench::histogram> uncorrected(threads);
+
+  // runs the benchmark once with the given aggregate rate (elements per
+  // second) or closed-loop at rate 0 and returns the achieved rate
+  const auto run_at = [&](double rate) {
+    alloc::begin_run();
+    auto queue = std::make_unique<Q>();
+    bench::spin_barrier barrier{ threads + 1 };
+    for (std::size_t thread = 0; thread < threads; ++thread) {
+      corrected[thread].reset();
+      uncorrected[thread].reset();
+    }
+
+    // the (mean) number of cycles between two elements of the same producer
+    const auto interval = rate == 0.0
+        ? 0.0
+        : static_cast<double>(producers) * 1e9 / rate / bench::ns_per_cycle();
+
+    // runs each thread on the persistent worker with the same id
+    auto& workers = bench::worker_pool::shared();
+
+    // spawns the producer threads (ids 0 to producers - 1) and the consumer
+    // threads, which dequeue until all enqueued elements have been retrieved
+    for (std::size_t thread = 0; thread < threads; ++thread) {
+      workers.spawn(thread, [&, thread] {
+        auto&& queue_ref = make_queue_ref(*queue, thread);
+
+        // all threads synchronize at this barrier before starting
+        barrier.wait();
+
+        if (thread < producers) {
+          const auto elems = &slots[2 * thread * enqs_per_producer];
+          std::minstd_rand rng{ static_cast<std::uint_fast32_t>(thread + 1) };
+          std::exponential_distribution<double> gaps{ 1.0 };
+
+          // the fixed schedules of all producers are staggered evenly
+          auto next = static_cast<double>(bench::rdtsc());
+          if (!poisson) {
+            next += interval * static_cast<double>(thread) / static_cast<double>(producers);
+          }
+
+          for (std::size_t op = 0; op < enqs_per_producer; ++op) {
+            next += poisson ? interval * gaps(rng) : (op == 0 ? 0.0 : interval);
+
+            // a producer that has fallen behind its schedule sends at once, but
+            // the schedule itself is never shifted
+            const auto intended = static_cast<std::uint64_t>(next);
+            auto now = bench::rdtsc();
+            while (now < intended) {
+              now = bench::rdtsc();
+            }
+
+            const auto elem = &elems[2 * op];
+            elem[0] = interval == 0.0 ? now : intended;
+            elem[1] = now;
+            queue_ref.enqueue(elem);
+          }
+        } else {
+          // the first consumer also dequeues the remainder
+          const auto consumer = thread - producers;
+          auto deqs = total_enqs / consumers;
+          if (consumer == 0) {
+            deqs += total_enqs % consumers;
+          }
+
+          // the producers are paced by their schedule, so only the consumers
+          // think, i.e., spend a service time on each element
+          bench::think_time think{ options.think, thread };
+          std::size_t dequeued = 0;
+          while (dequeued < deqs) {
+            auto elem = queue_ref.dequeue();
+            if (elem == nullptr) {
+              continue;
+            }
+
+            const auto now = bench::rdtsc();
+            check_elem(elem);
+
+            // the time stamp counters of different cores may be slightly off
+            corrected[thread].record(now - std::min<std::uint64_t>(now, elem[0]));
+            uncorrected[thread].record(now - std::min<std::uint64_t>(now, elem[1]));
+            dequeued += 1;
+            think.pause();
+          }
+        }
+
+        // all threads synchronize at this barrier before completing
+        barrier.wait();
+      });
+    }
+
+    barrier.wait();
+    // measures total time once all threads have arrived at the barrier
+    const auto start = std::chrono::high_resolution_clock::now();
+    barrier.wait();
+    const auto stop = std::chrono::high_resolution_clock::now();
+    const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start);
+
+    // waits for all workers to complete their jobs
+    workers.join_all();
+
+    const auto achieved =
+        static_cast<double>(total_enqs) * 1e9 / static_cast<double>(std::max<std::int64_t>(duration.count(), 1));
+
+    // print measurements to stdout, the closed-loop run has no offered rate
+    std::cout
+        << queue_name
+        << "," << threads
+        << "," << duration.count()
+        << "," << 2 * total_enqs
+        << "," << (rate == 0.0 ? "closed" : poisson ? "poisson" : "fixed")
+        << "," << static_cast<std::size_t>(rate)
+        << "," << achieved;
+    print_latencies(corrected, uncorrected);
+    events::print_totals(std::cout);
+    alloc::print_totals(std::cout, 2 * total_enqs);
+    std::cout << std::endl;
+
+    return achieved;
+  };
+
+  // execute benchmark for `runs` iterations
+  for (auto run = 0; run < runs; ++run) {
+    if (options.rate != 0) {
+      run_at(static_cast<double>(options.rate));
+      continue;
+    }
+
+    // the latency-vs-offered-load curve is relative to each run's saturation
+    // throughput, measured closed-loop with the same threads
+    const auto saturation = run_at(0.0);
+    for (const auto load : OPEN_LOOP_LOADS) {
+      run_at(load * saturation);
+    }
   }
 }
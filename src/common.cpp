@@ -1,32 +1,22 @@
 #include "common.hpp"
 
+#include <algorithm>
 #include <charconv>
-#include <chrono>
+#include <cstdint>
 #include <iostream>
 #include <stdexcept>
+#include <string>
 #include <string_view>
+#include <tuple>
+#include <utility>
 
 #include <pthread.h>
 
+#include "histogram.hpp"
+#include "topology.hpp"
+
 namespace bench {
 namespace {
-std::size_t measure_ns_per_iteration() {
-  using nanosecs = std::chrono::nanoseconds;
-  constexpr auto iters = 1000;
-
-  const auto start = std::chrono::high_resolution_clock::now();
-  volatile auto i = 0;
-  while (i < iters) {
-    i = i + 1;
-  }
-  const auto end = std::chrono::high_resolution_clock::now();
-
-  const nanosecs dur = end - start;
-  const auto ns_per_iter = dur.count() / iters;
-
-  return ns_per_iter == 0 ? 1 : ns_per_iter;
-}
-
 std::size_t string_view_to_size(std::string_view string) {
   std::size_t result;
   const auto success = std::from_chars(string.begin(), string.end(), result);
@@ -36,6 +26,52 @@ std::size_t string_view_to_size(std::string_view string) {
 
   return result;
 }
+
+std::size_t parse_option_size(std::string_view key, std::string_view value) {
+  std::size_t res;
+  const auto err = std::from_chars(value.begin(), value.end(), res);
+  if (err.ec != std::errc() || err.ptr != value.end()) {
+    throw std::invalid_argument(
+        "option '" + std::string(key) + "' must be a non-negative integer"
+    );
+  }
+
+  return res;
+}
+
+/** parses `on` or `off` */
+bool parse_option_switch(std::string_view key, std::string_view value) {
+  if (value == "on") {
+    return true;
+  }
+
+  if (value == "off") {
+    return false;
+  }
+
+  throw std::invalid_argument("option '" + std::string(key) + "' must be 'on' or 'off'");
+}
+
+/** parses `<first><sep><second>`, at least one of which must be positive */
+weights_t parse_option_weights(std::string_view key, std::string_view value, char sep) {
+  const auto pos = value.find(sep);
+  if (pos == std::string_view::npos) {
+    throw std::invalid_argument(
+        "option '" + std::string(key) + "' must have the form <n>" + sep + "<m>"
+    );
+  }
+
+  const weights_t res{
+      parse_option_size(key, value.substr(0, pos)),
+      parse_option_size(key, value.substr(pos + 1))
+  };
+
+  if (res.empty()) {
+    throw std::invalid_argument("option '" + std::string(key) + "' must not be all zero");
+  }
+
+  return res;
+}
 }
 
 queue_type_t parse_queue_str(const std::string_view queue) {
@@ -79,9 +115,50 @@ queue_type_t parse_queue_str(const std::string_view queue) {
     return queue_type_t::YMC;
   }
 
+  if (queue == "fc") {
+    return queue_type_t::FC;
+  }
+
+  if (queue == "mtx") {
+    return queue_type_t::MTX;
+  }
+
+  if (queue == "tlq") {
+    return queue_type_t::TLQ;
+  }
+
+  if (queue == "tkt") {
+    return queue_type_t::TKT;
+  }
+
+  if (queue == "shd") {
+    return queue_type_t::SHD;
+  }
+
+  if (queue == "shd_lcr") {
+    return queue_type_t::SHD_LCR;
+  }
+
+  if (queue == "spsc") {
+    return queue_type_t::SPSC;
+  }
+
+  if (queue == "mpsc") {
+    return queue_type_t::MPSC;
+  }
+
+  if (queue == "kpq") {
+    return queue_type_t::KPQ;
+  }
+
+  if (queue == "hrq") {
+    return queue_type_t::HRQ;
+  }
+
   throw std::invalid_argument(
-      "argument `queue` must be one of 'lcr', 'loo', 'faa', 'faa_v1', 'faa_v2',"
-      "'msc', 'scq2', 'scqd' or 'ymc'"
+      "argument `queue` must be one of 'lcr', 'loo', 'faa', 'faa_v1', 'faa_v2', "
+      "'faa_v3', 'msc', 'scq2', 'scqd', 'ymc', 'fc', 'mtx', 'tlq', 'tkt', 'shd', "
+      "'shd_lcr', 'spsc', 'mpsc', 'kpq' or 'hrq'"
   );
 }
 
@@ -106,8 +183,54 @@ bench_type_t parse_bench_str(const std::string_view bench) {
     return bench_type_t::MIXED;
   }
 
+  if (bench == "rank") {
+    return bench_type_t::RANK;
+  }
+
+  if (bench == "spsc") {
+    return bench_type_t::SPSC;
+  }
+
+  if (bench == "mpsc") {
+    return bench_type_t::MPSC;
+  }
+
+  if (bench == "latency") {
+    return bench_type_t::LATENCY;
+  }
+
+  if (bench == "bulk") {
+    return bench_type_t::BULK;
+  }
+
+  if (bench == "size") {
+    return bench_type_t::SIZE;
+  }
+
+  if (bench == "notify") {
+    return bench_type_t::NOTIFY;
+  }
+
+  if (bench == "async") {
+    return bench_type_t::ASYNC;
+  }
+
+  if (bench == "forkjoin") {
+    return bench_type_t::FORKJOIN;
+  }
+
+  if (bench == "pipeline") {
+    return bench_type_t::PIPELINE;
+  }
+
+  if (bench == "openloop") {
+    return bench_type_t::OPENLOOP;
+  }
+
   throw std::invalid_argument(
-      "argument `bench` must be one of 'pairs', 'bursts', 'mixed', 'reads' or 'writes'"
+      "argument `bench` must be one of 'pairs', 'bursts', 'mixed', 'reads', 'writes', 'rank', "
+      "'spsc', 'mpsc', 'latency', 'bulk', 'size', 'notify', 'async', 'forkjoin', 'pipeline' "
+      "or 'openloop'"
   );
 }
 
@@ -144,10 +267,328 @@ std::size_t parse_runs_str(const std::string_view runs) {
   return static_cast<std::size_t>(val);
 }
 
+std::vector<pipeline_stage_t> parse_pipeline_str(std::string_view stages) {
+  constexpr const char* ERR_MSG =
+      "option 'stages' must contain at least two '/' separated stages, each a positive "
+      "thread count optionally followed by ':' and the work per element in ns";
+
+  const auto parse_int = [&](std::string_view str) {
+    std::size_t res;
+    const auto err = std::from_chars(str.begin(), str.end(), res);
+    if (err.ec != std::errc() || err.ptr != str.end()) {
+      throw std::invalid_argument(ERR_MSG);
+    }
+
+    return res;
+  };
+
+  std::vector<pipeline_stage_t> res{};
+  while (true) {
+    const auto end = stages.find('/');
+    const auto stage = stages.substr(0, end);
+    const auto sep = stage.find(':');
+
+    const auto threads = parse_int(stage.substr(0, sep));
+    const auto work_ns = sep == std::string_view::npos ? 0 : parse_int(stage.substr(sep + 1));
+    if (threads == 0) {
+      throw std::invalid_argument(ERR_MSG);
+    }
+
+    res.push_back({ threads, work_ns });
+    if (end == std::string_view::npos) {
+      break;
+    }
+
+    stages.remove_prefix(end + 1);
+  }
+
+  if (res.size() < 2) {
+    throw std::invalid_argument(ERR_MSG);
+  }
+
+  return res;
+}
+
+think_time_t parse_think_str(std::string_view think) {
+  constexpr const char* ERR_MSG =
+      "option 'think' must be 'fixed:<ns>', 'uniform:<min>-<max>', 'exp:<mean>' or "
+      "'bimodal:<short>/<long>:<%long>'";
+
+  const auto parse_int = [&](std::string_view str) {
+    std::size_t res;
+    const auto err = std::from_chars(str.begin(), str.end(), res);
+    if (err.ec != std::errc() || err.ptr != str.end()) {
+      throw std::invalid_argument(ERR_MSG);
+    }
+
+    return res;
+  };
+
+  // splits `str` at the first `sep`, which must be present
+  const auto split = [&](std::string_view str, char sep) {
+    const auto pos = str.find(sep);
+    if (pos == std::string_view::npos) {
+      throw std::invalid_argument(ERR_MSG);
+    }
+
+    return std::pair{ str.substr(0, pos), str.substr(pos + 1) };
+  };
+
+  const auto [dist, params] = split(think, ':');
+  think_time_t res{};
+  if (dist == "fixed") {
+    res.dist = think_dist_t::FIXED;
+    res.first_ns = parse_int(params);
+  } else if (dist == "uniform") {
+    const auto [min, max] = split(params, '-');
+    res.dist = think_dist_t::UNIFORM;
+    res.first_ns = parse_int(min);
+    res.second_ns = parse_int(max);
+    if (res.first_ns > res.second_ns) {
+      throw std::invalid_argument("option 'think' requires the minimum not to exceed the maximum");
+    }
+  } else if (dist == "exp") {
+    res.dist = think_dist_t::EXPONENTIAL;
+    res.first_ns = parse_int(params);
+  } else if (dist == "bimodal") {
+    const auto [times, percent] = split(params, ':');
+    const auto [short_ns, long_ns] = split(times, '/');
+    res.dist = think_dist_t::BIMODAL;
+    res.first_ns = parse_int(short_ns);
+    res.second_ns = parse_int(long_ns);
+    res.long_percent = parse_int(percent);
+    if (res.long_percent > 100) {
+      throw std::invalid_argument("option 'think' requires a percentage of at most 100");
+    }
+  } else {
+    throw std::invalid_argument(ERR_MSG);
+  }
+
+  return res;
+}
+
+options_t parse_options(std::span<char* const> args) {
+  options_t res{};
+  auto has_format = false;
+  for (const std::string_view arg : args) {
+    const auto sep = arg.find('=');
+    if (!arg.starts_with("--") || sep == std::string_view::npos) {
+      throw std::invalid_argument("optional arguments must have the form `--key=value`");
+    }
+
+    const auto key = arg.substr(2, sep - 2);
+    const auto value = arg.substr(sep + 1);
+    if (key == "stages") {
+      res.stages = parse_pipeline_str(value);
+    } else if (key == "latency") {
+      res.latency_interval = parse_option_size(key, value);
+    } else if (key == "duration") {
+      res.duration_ms = parse_option_size(key, value);
+    } else if (key == "roles") {
+      res.roles = parse_option_weights(key, value, ':');
+      if (res.roles.first == 0 || res.roles.second == 0) {
+        throw std::invalid_argument("option 'roles' requires producers and consumers");
+      }
+    } else if (key == "mix") {
+      res.mix = parse_option_weights(key, value, '/');
+    } else if (key == "placement") {
+      if (value == "interleaved") {
+        res.placement = role_placement_t::INTERLEAVED;
+      } else if (value == "grouped") {
+        res.placement = role_placement_t::GROUPED;
+      } else {
+        throw std::invalid_argument("option 'placement' must be 'interleaved' or 'grouped'");
+      }
+    } else if (key == "rate") {
+      res.rate = parse_option_size(key, value);
+    } else if (key == "arrival") {
+      if (value == "fixed") {
+        res.arrival = arrival_t::FIXED;
+      } else if (value == "poisson") {
+        res.arrival = arrival_t::POISSON;
+      } else {
+        throw std::invalid_argument("option 'arrival' must be 'fixed' or 'poisson'");
+      }
+    } else if (key == "think") {
+      res.think = parse_think_str(value);
+    } else if (key == "thread-stats") {
+      res.thread_stats = parse_option_switch(key, value);
+    } else if (key == "perf") {
+      res.perf_counters = parse_option_switch(key, value);
+    } else if (key == "warmup") {
+      res.warmup = parse_option_size(key, value);
+    } else if (key == "affinity") {
+      if (value == "linear") {
+        res.affinity = affinity_t::LINEAR;
+      } else if (value == "compact") {
+        res.affinity = affinity_t::COMPACT;
+      } else if (value == "scatter") {
+        res.affinity = affinity_t::SCATTER;
+      } else if (value == "cores") {
+        res.affinity = affinity_t::CORES;
+      } else if (value == "smt") {
+        res.affinity = affinity_t::SMT;
+      } else {
+        throw std::invalid_argument(
+            "option 'affinity' must be 'linear', 'compact', 'scatter', 'cores' or 'smt'"
+        );
+      }
+    } else if (key == "cpus") {
+      res.cpus = topology::parse_cpu_list(value);
+      if (res.cpus.empty()) {
+        throw std::invalid_argument("option 'cpus' must be a list of CPUs (e.g., '0-7,16-23')");
+      }
+    } else if (key == "output") {
+      if (value.empty()) {
+        throw std::invalid_argument("option 'output' must not be empty");
+      }
+
+      res.output = value;
+    } else if (key == "format") {
+      if (value == "csv") {
+        res.format = output_format_t::CSV;
+      } else if (value == "json") {
+        res.format = output_format_t::JSON;
+      } else {
+        throw std::invalid_argument("option 'format' must be 'csv' or 'json'");
+      }
+
+      has_format = true;
+    } else {
+      throw std::invalid_argument("unknown option `--" + std::string(key) + "`");
+    }
+  }
+
+  if (!res.cpus.empty()) {
+    if (res.affinity != affinity_t::LINEAR) {
+      throw std::invalid_argument("options 'affinity' and 'cpus' are mutually exclusive");
+    }
+
+    res.affinity = affinity_t::LIST;
+  }
+
+  if (!has_format && res.output.ends_with(".json")) {
+    res.format = output_format_t::JSON;
+  }
+
+  return res;
+}
+
+std::vector<std::size_t> affinity_cpus(const options_t& options) {
+  if (options.affinity == affinity_t::LIST) {
+    return options.cpus;
+  }
+
+  const auto cpus = topology::read_cpus();
+  std::vector<std::size_t> res{};
+  res.reserve(cpus.size());
+  if (options.affinity == affinity_t::LINEAR) {
+    for (const auto& cpu : cpus) {
+      res.push_back(cpu.id);
+    }
+
+    return res;
+  }
+
+  // the CPUs of each core (SMT siblings) of each package, all in ascending order
+  using core_t = std::vector<std::size_t>;
+  std::vector<std::vector<core_t>> packages{};
+  auto sorted = cpus;
+  std::sort(sorted.begin(), sorted.end(), [](const auto& lhs, const auto& rhs) {
+    return std::tie(lhs.package, lhs.core, lhs.id) < std::tie(rhs.package, rhs.core, rhs.id);
+  });
+
+  for (std::size_t idx = 0; idx < sorted.size(); ++idx) {
+    const auto& cpu = sorted[idx];
+    if (idx == 0 || cpu.package != sorted[idx - 1].package) {
+      packages.emplace_back();
+    }
+
+    if (idx == 0 || cpu.package != sorted[idx - 1].package || cpu.core != sorted[idx - 1].core) {
+      packages.back().emplace_back();
+    }
+
+    packages.back().back().push_back(cpu.id);
+  }
+
+  std::size_t max_cores = 0, max_siblings = 0;
+  for (const auto& package : packages) {
+    max_cores = std::max(max_cores, package.size());
+    for (const auto& core : package) {
+      max_siblings = std::max(max_siblings, core.size());
+    }
+  }
+
+  // appends the sibling of the core, if it exists
+  const auto append = [&](const std::vector<core_t>& package, std::size_t core, std::size_t sibling) {
+    if (core < package.size() && sibling < package[core].size()) {
+      res.push_back(package[core][sibling]);
+    }
+  };
+
+  switch (options.affinity) {
+    case affinity_t::COMPACT:
+      for (const auto& package : packages) {
+        for (std::size_t sibling = 0; sibling < max_siblings; ++sibling) {
+          for (std::size_t core = 0; core < package.size(); ++core) {
+            append(package, core, sibling);
+          }
+        }
+      }
+      break;
+    case affinity_t::SCATTER:
+      for (std::size_t sibling = 0; sibling < max_siblings; ++sibling) {
+        for (std::size_t core = 0; core < max_cores; ++core) {
+          for (const auto& package : packages) {
+            append(package, core, sibling);
+          }
+        }
+      }
+      break;
+    case affinity_t::CORES:
+      for (std::size_t sibling = 0; sibling < max_siblings; ++sibling) {
+        for (const auto& package : packages) {
+          for (std::size_t core = 0; core < package.size(); ++core) {
+            append(package, core, sibling);
+          }
+        }
+      }
+      break;
+    case affinity_t::SMT:
+      for (const auto& package : packages) {
+        for (const auto& core : package) {
+          res.insert(res.end(), core.begin(), core.end());
+        }
+      }
+      break;
+    default: throw std::runtime_error("unreachable branch");
+  }
+
+  return res;
+}
+
+std::size_t max_threads(const options_t& options) {
+  switch (options.affinity) {
+    case affinity_t::LINEAR:
+    case affinity_t::SCATTER:
+    case affinity_t::CORES:
+      return topology::count_cores(topology::read_cpus());
+    case affinity_t::LIST:
+      return options.cpus.size();
+    default:
+      return topology::read_cpus().size();
+  }
+}
+
 void pin_current_thread(std::size_t thread_id) {
+  const auto cpu = topology::cpu_of_thread(thread_id);
+  if (cpu >= CPU_SETSIZE) {
+    throw std::invalid_argument("CPU " + std::to_string(cpu) + " exceeds the maximum CPU number");
+  }
+
   cpu_set_t set;
   CPU_ZERO(&set);
-  CPU_SET(thread_id, &set);
+  CPU_SET(cpu, &set);
 
   const auto res = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &set);
   if (res != 0) {
@@ -156,10 +597,11 @@ void pin_current_thread(std::size_t thread_id) {
 }
 
 void spin_for_ns(std::size_t ns) {
-  static const auto NS_PER_ITER = measure_ns_per_iteration();
-  volatile auto i = 0;
-  while (i < ns * NS_PER_ITER) {
-    i = i + 1;
-  }
+  // the deadline is measured in time stamp counter cycles, since the speed
+  // of a counting loop varies too much with the CPU's frequency and the code
+  // surrounding each call
+  static const auto CYCLES_PER_NS = 1.0 / ns_per_cycle();
+  const auto stop = rdtsc() + static_cast<std::uint64_t>(static_cast<double>(ns) * CYCLES_PER_NS);
+  while (rdtsc() < stop) {}
 }
 }
@@ -0,0 +1,690 @@
+#include "results.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <ctime>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+
+#include <unistd.h>
+
+#include "alloc_stats.hpp"
+#include "perf_counters.hpp"
+#include "queue_events.hpp"
+#include "topology.hpp"
+
+// the build configuration is passed in by CMake, the git revision is the one
+// at the time the build was configured
+#ifndef BENCH_COMPILER
+#define BENCH_COMPILER __VERSION__
+#endif
+#ifndef BENCH_CXX_FLAGS
+#define BENCH_CXX_FLAGS "unknown"
+#endif
+#ifndef BENCH_ALLOCATOR
+#define BENCH_ALLOCATOR "unknown"
+#endif
+#ifndef BENCH_CASCADE_LAKE
+#define BENCH_CASCADE_LAKE "unknown"
+#endif
+#ifndef BENCH_GIT_REVISION
+#define BENCH_GIT_REVISION ""
+#endif
+
+namespace bench {
+namespace {
+/** the number of significant digits of all computed statistics */
+constexpr int STATS_PRECISION = 10;
+
+/** returns the value of the field, if it is a finite number */
+std::optional<double> parse_number(std::string_view field) {
+  double res;
+  const auto err = std::from_chars(field.begin(), field.end(), res);
+  if (err.ec != std::errc() || err.ptr != field.end() || !std::isfinite(res)) {
+    return std::nullopt;
+  }
+
+  return res;
+}
+
+std::vector<std::string> split_fields(std::string_view line) {
+  std::vector<std::string> res{};
+  while (true) {
+    const auto sep = line.find(',');
+    res.emplace_back(line.substr(0, sep));
+    if (sep == std::string_view::npos) {
+      return res;
+    }
+
+    line.remove_prefix(sep + 1);
+  }
+}
+
+/** returns the interpolated quantile (0 to 1) of the sorted values */
+double quantile(const std::vector<double>& sorted, double q) {
+  const auto pos = q * static_cast<double>(sorted.size() - 1);
+  const auto lower = static_cast<std::size_t>(pos);
+  const auto upper = std::min(lower + 1, sorted.size() - 1);
+  return sorted[lower] + (pos - static_cast<double>(lower)) * (sorted[upper] - sorted[lower]);
+}
+
+/** returns the two-sided 95% quantile of Student's t-distribution */
+double t_quantile_95(std::size_t degrees) {
+  constexpr std::array<double, 30> TABLE{
+      12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+      2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+      2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+  };
+
+  if (degrees <= TABLE.size()) {
+    return TABLE[degrees - 1];
+  }
+
+  return degrees <= 40 ? 2.021 : degrees <= 60 ? 2.000 : degrees <= 120 ? 1.980 : 1.960;
+}
+
+/** returns the runs outside of Tukey's fences, requires at least 4 values */
+std::vector<std::size_t> tukey_outliers(const std::vector<double>& values) {
+  std::vector<std::size_t> res{};
+  if (values.size() < 4) {
+    return res;
+  }
+
+  auto sorted = values;
+  std::sort(sorted.begin(), sorted.end());
+  const auto q1 = quantile(sorted, 0.25), q3 = quantile(sorted, 0.75);
+  const auto low = q1 - 1.5 * (q3 - q1), high = q3 + 1.5 * (q3 - q1);
+  for (std::size_t run = 0; run < values.size(); ++run) {
+    if (values[run] < low || values[run] > high) {
+      res.push_back(run);
+    }
+  }
+
+  return res;
+}
+
+std::string read_cpu_model() {
+  std::ifstream file{ "/proc/cpuinfo" };
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.starts_with("model name")) {
+      const auto sep = line.find(':');
+      return sep == std::string::npos ? line : line.substr(std::min(sep + 2, line.size()));
+    }
+  }
+
+  return "unknown";
+}
+
+std::string read_host_name() {
+  std::array<char, 256> buf{};
+  if (::gethostname(buf.data(), buf.size() - 1) != 0) {
+    return "unknown";
+  }
+
+  return buf.data();
+}
+
+std::string current_utc_time() {
+  const auto now = std::time(nullptr);
+  std::tm utc{};
+  ::gmtime_r(&now, &utc);
+
+  std::array<char, 32> buf{};
+  std::strftime(buf.data(), buf.size(), "%Y-%m-%dT%H:%M:%SZ", &utc);
+  return buf.data();
+}
+
+std::string json_string(std::string_view str) {
+  std::ostringstream res;
+  res << '"';
+  for (const auto ch : str) {
+    switch (ch) {
+      case '"':  res << "\\\""; break;
+      case '\\': res << "\\\\"; break;
+      case '\n': res << "\\n"; break;
+      case '\t': res << "\\t"; break;
+      default:
+        if (static_cast<unsigned char>(ch) < 0x20) {
+          res << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(ch) << std::dec;
+        } else {
+          res << ch;
+        }
+    }
+  }
+
+  res << '"';
+  return res.str();
+}
+
+/** formats the field as JSON number, if it is one, else as string */
+std::string json_field(std::string_view field) {
+  return parse_number(field).has_value() ? std::string(field) : json_string(field);
+}
+
+/** formats a computed statistic, empty if it is undefined (NaN) */
+std::string format_stat(double value, std::string_view undefined) {
+  if (std::isnan(value)) {
+    return std::string(undefined);
+  }
+
+  std::ostringstream res;
+  res << std::setprecision(STATS_PRECISION) << value;
+  return res.str();
+}
+
+std::string csv_field(std::string_view field) {
+  if (field.find_first_of(",\"\n") == std::string_view::npos) {
+    return std::string(field);
+  }
+
+  std::string res{ "\"" };
+  for (const auto ch : field) {
+    res += ch == '"' ? "\"\"" : std::string(1, ch);
+  }
+
+  return res + "\"";
+}
+
+/** returns the name of the summary file for the given CSV file */
+std::string summary_path(std::string_view path) {
+  if (path.ends_with(".csv")) {
+    path.remove_suffix(4);
+  }
+
+  return std::string(path) + ".summary.csv";
+}
+}
+
+std::vector<std::string> column_names(bench_type_t bench_type, const options_t& options) {
+  std::vector<std::string> res{ "queue", "threads" };
+  const auto append = [&](std::initializer_list<std::string_view> names) {
+    res.insert(res.end(), names.begin(), names.end());
+  };
+
+  const auto append_latencies = [&](std::string_view enq, std::string_view deq) {
+    for (const auto prefix : { enq, deq }) {
+      for (const auto suffix : { "p50_ns", "p90_ns", "p99_ns", "p99.9_ns", "max_ns" }) {
+        res.push_back(std::string(prefix) + "_" + suffix);
+      }
+    }
+  };
+
+  auto uses_run_control = true;
+  switch (bench_type) {
+    case bench_type_t::PAIRS:
+    case bench_type_t::READS:
+    case bench_type_t::WRITES:
+    case bench_type_t::MIXED:
+      append({ "duration_ns", "total_ops" });
+      if (options.latency_interval != 0) {
+        append_latencies("enq", "deq");
+      }
+      break;
+    case bench_type_t::BURSTS:
+      append({ "enq_duration_ns", "deq_duration_ns", "total_ops" });
+      if (options.latency_interval != 0) {
+        append_latencies("enq", "deq");
+      }
+      break;
+    case bench_type_t::RANK:
+      append({ "duration_ns", "total_ops", "rank_error_mean", "rank_error_max" });
+      break;
+    case bench_type_t::LATENCY:
+      append({ "duration_ns", "total_ops", "enq_p99.99_ns", "enq_max_ns", "deq_p99.99_ns", "deq_max_ns" });
+      break;
+    case bench_type_t::SIZE:
+      append({ "duration_ns", "total_ops", "sample_ns", "size_error_mean", "size_mean", "samples" });
+      break;
+    case bench_type_t::SPSC:
+    case bench_type_t::MPSC:
+    case bench_type_t::BULK:
+      append({ "duration_ns", "total_ops" });
+      break;
+    case bench_type_t::PIPELINE:
+      append({ "duration_ns", "total_ops", "stages", "msgs_per_sec", "occupancy" });
+      break;
+    case bench_type_t::NOTIFY:
+      append({ "duration_ns", "total_ops", "mode", "syscalls_per_msg", "latency_mean_ns", "latency_p99_ns" });
+      uses_run_control = false;
+      break;
+    case bench_type_t::ASYNC:
+      append({ "duration_ns", "total_ops", "mode", "ns_per_msg" });
+      uses_run_control = false;
+      break;
+    case bench_type_t::FORKJOIN:
+      append({ "duration_ns", "jobs", "workload", "mode", "steals", "overflows" });
+      uses_run_control = false;
+      break;
+    case bench_type_t::OPENLOOP:
+      append({ "duration_ns", "total_ops", "arrival", "offered_rate", "achieved_rate" });
+      append_latencies("corrected", "uncorrected");
+      uses_run_control = false;
+      break;
+  }
+
+  if (uses_run_control) {
+    if (options.duration_ms != 0) {
+      append({ "ops_per_sec", "thread_ops" });
+    }
+
+    if (options.perf_counters) {
+      for (const auto& event : PERF_EVENTS) {
+        res.push_back(std::string(event.name) + "_per_op");
+      }
+
+      append({ "context_switches_per_op" });
+    }
+
+    if (options.thread_stats) {
+      append({
+          "jain_index", "min_thread_ops_per_sec", "max_thread_ops_per_sec",
+          "start_skew_ns", "stop_skew_ns", "thread_stats_ops", "thread_empty_deqs", "thread_elapsed_ns"
+      });
+    }
+  }
+
+#ifdef QUEUE_EVENTS
+  append({ "queue_events" });
+#endif
+
+#ifdef ALLOC_STATS
+  for (const auto& column : alloc::COLUMN_NAMES) {
+    res.emplace_back(column);
+  }
+#endif
+
+  return res;
+}
+
+/********** results_writer ****************************************************/
+
+results_writer::results_writer(
+    bench_type_t           bench_type,
+    std::size_t            total_ops,
+    std::size_t            runs,
+    const options_t&       options,
+    std::span<char* const> args
+) :
+  m_bench{ display_str(bench_type) },
+  m_runs{ runs },
+  m_format{ options.format },
+  m_path{ options.output },
+  m_columns{ column_names(bench_type, options) },
+  m_file{ options.output },
+  m_buf{ std::cout.rdbuf(), m_lines },
+  m_stdout{ std::cout.rdbuf() }
+{
+  if (!this->m_file) {
+    throw std::runtime_error("failed to open output file '" + this->m_path + "'");
+  }
+
+  std::string command_line{};
+  for (const auto arg : args) {
+    command_line += (command_line.empty() ? "" : " ") + std::string(arg);
+  }
+
+  // the packages, cores and CPUs as read from sysfs and the CPU of each thread
+  const auto topology = topology::read_cpus();
+  std::vector<std::size_t> packages{};
+  for (const auto& cpu : topology) {
+    if (std::find(packages.begin(), packages.end(), cpu.package) == packages.end()) {
+      packages.push_back(cpu.package);
+    }
+  }
+
+  std::string thread_cpus{};
+  for (const auto cpu : affinity_cpus(options)) {
+    thread_cpus += (thread_cpus.empty() ? "" : "/") + std::to_string(cpu);
+  }
+
+  const std::string git_revision{ BENCH_GIT_REVISION };
+#ifdef QUEUE_EVENTS
+  constexpr std::string_view queue_events{ "ON" };
+#else
+  constexpr std::string_view queue_events{ "OFF" };
+#endif
+#ifdef ALLOC_STATS
+  constexpr std::string_view alloc_stats{ "ON" };
+#else
+  constexpr std::string_view alloc_stats{ "OFF" };
+#endif
+
+  this->m_metadata = {
+      { "host", read_host_name() },
+      { "cpu_model", read_cpu_model() },
+      { "cores", std::to_string(topology::count_cores(topology)) },
+      { "logical_cpus", std::to_string(std::thread::hardware_concurrency()) },
+      {
+          "topology",
+          std::to_string(packages.size()) + " packages, "
+              + std::to_string(topology::count_cores(topology)) + " physical cores, "
+              + std::to_string(topology.size()) + " online CPUs"
+      },
+      { "affinity", std::string(display_str(options.affinity)) },
+      { "thread_cpus", thread_cpus },
+      { "compiler", BENCH_COMPILER },
+      { "cxx_flags", BENCH_CXX_FLAGS },
+      { "allocator", BENCH_ALLOCATOR },
+      { "cascade_lake", BENCH_CASCADE_LAKE },
+      { "queue_events", std::string(queue_events) },
+      { "alloc_stats", std::string(alloc_stats) },
+      { "git_revision", git_revision.empty() ? "unknown" : git_revision },
+      { "timestamp", current_utc_time() },
+      { "command", command_line },
+      { "bench", this->m_bench },
+      { "total_ops", std::to_string(total_ops) },
+      { "runs", std::to_string(runs) },
+  };
+
+  std::cout.rdbuf(&this->m_buf);
+}
+
+results_writer::~results_writer() noexcept {
+  std::cout.rdbuf(this->m_stdout);
+}
+
+void results_writer::finish() {
+  std::cout.flush();
+
+  auto records = this->collect_records();
+  const auto summary = this->summarize(records);
+  if (this->m_format == output_format_t::JSON) {
+    this->write_json(records, summary);
+  } else {
+    this->write_csv(records, summary);
+  }
+}
+
+std::string results_writer::column_name(std::size_t idx) const {
+  // any mismatch with the actual output must not lose any values
+  return idx < this->m_columns.size() ? this->m_columns[idx] : "col" + std::to_string(idx);
+}
+
+std::vector<results_writer::record_t> results_writer::collect_records() const {
+  std::vector<record_t> res{};
+  for (const auto& line : this->m_lines) {
+    if (!line.empty()) {
+      res.push_back({ split_fields(line), 0, 0 });
+    }
+  }
+
+  // each block of consecutive lines for the same queue and thread count holds
+  // all runs one after another, each with the same number of lines
+  for (std::size_t begin = 0; begin < res.size();) {
+    auto end = begin + 1;
+    while (end < res.size() && res[end].fields[0] == res[begin].fields[0]
+        && res[end].fields.size() > 1 && res[begin].fields.size() > 1
+        && res[end].fields[1] == res[begin].fields[1]) {
+      ++end;
+    }
+
+    const auto count = end - begin;
+    const auto per_run = this->m_runs != 0 && count % this->m_runs == 0 ? count / this->m_runs : 1;
+    for (auto idx = begin; idx < end; ++idx) {
+      res[idx].run = (idx - begin) / per_run;
+      res[idx].variant = (idx - begin) % per_run;
+    }
+
+    begin = end;
+  }
+
+  return res;
+}
+
+std::vector<results_writer::summary_t> results_writer::summarize(std::vector<record_t>& records) const {
+  // groups the runs of each variant in the order of their first appearance
+  std::vector<std::vector<std::size_t>> groups{};
+  std::map<std::tuple<std::string, std::string, std::size_t>, std::size_t> group_ids{};
+  for (std::size_t idx = 0; idx < records.size(); ++idx) {
+    const auto& record = records[idx];
+    const auto threads = record.fields.size() > 1 ? record.fields[1] : std::string{};
+    const auto [it, inserted] = group_ids.try_emplace({ record.fields[0], threads, record.variant }, groups.size());
+    if (inserted) {
+      groups.emplace_back();
+    }
+
+    groups[it->second].push_back(idx);
+  }
+
+  std::vector<summary_t> res{};
+  for (const auto& group : groups) {
+    const auto& first = records[group.front()];
+    const auto columns = std::accumulate(
+        group.begin(), group.end(), std::size_t{ 0 },
+        [&](std::size_t max, std::size_t idx) { return std::max(max, records[idx].fields.size()); }
+    );
+
+    // collects the values of each column, which is numeric in all runs
+    std::string params{};
+    std::vector<std::pair<std::size_t, std::vector<double>>> numeric{};
+    for (std::size_t col = 2; col < columns; ++col) {
+      std::vector<double> values{};
+      auto shared = true;
+      for (const auto idx : group) {
+        const auto& fields = records[idx].fields;
+        const auto value = col < fields.size() ? parse_number(fields[col]) : std::nullopt;
+        if (value.has_value()) {
+          values.push_back(*value);
+        }
+
+        shared = shared && col < fields.size() && col < first.fields.size() && fields[col] == first.fields[col];
+      }
+
+      if (values.size() == group.size()) {
+        numeric.emplace_back(col, std::move(values));
+      } else if (values.empty() && shared) {
+        params += (params.empty() ? "" : ";") + this->column_name(col) + "=" + first.fields[col];
+      }
+    }
+
+    for (auto& [col, values] : numeric) {
+      const auto count = values.size();
+      const auto mean = std::accumulate(values.begin(), values.end(), 0.0) / static_cast<double>(count);
+      auto stddev = std::numeric_limits<double>::quiet_NaN();
+      auto half_width = std::numeric_limits<double>::quiet_NaN();
+      if (count > 1) {
+        const auto squares = std::accumulate(values.begin(), values.end(), 0.0, [&](double sum, double value) {
+          return sum + (value - mean) * (value - mean);
+        });
+        stddev = std::sqrt(squares / static_cast<double>(count - 1));
+        half_width = t_quantile_95(count - 1) * stddev / std::sqrt(static_cast<double>(count));
+      }
+
+      auto outlier_runs = tukey_outliers(values);
+      for (auto& run : outlier_runs) {
+        run = records[group[run]].run;
+      }
+
+      // the records are flagged by their first measurement (i.e., duration)
+      if (col == 2) {
+        for (const auto run : tukey_outliers(values)) {
+          records[group[run]].outlier = true;
+        }
+      }
+
+      auto sorted = values;
+      std::sort(sorted.begin(), sorted.end());
+      res.push_back({
+          first.fields[0], first.fields.size() > 1 ? first.fields[1] : std::string{}, first.variant, params,
+          this->column_name(col), count, quantile(sorted, 0.5), mean, stddev,
+          mean - half_width, mean + half_width, std::move(outlier_runs)
+      });
+    }
+  }
+
+  return res;
+}
+
+void results_writer::write_csv(const std::vector<record_t>& records, const std::vector<summary_t>& summary) {
+  const auto write_metadata = [&](std::ostream& os) {
+    for (const auto& [key, value] : this->m_metadata) {
+      os << "# " << key << ": " << value << "\n";
+    }
+  };
+
+  const auto columns = std::accumulate(
+      records.begin(), records.end(), this->m_columns.size(),
+      [](std::size_t max, const record_t& record) { return std::max(max, record.fields.size()); }
+  );
+
+  write_metadata(this->m_file);
+  this->m_file << "queue,bench,threads,run,variant,outlier";
+  for (std::size_t col = 2; col < columns; ++col) {
+    this->m_file << "," << this->column_name(col);
+  }
+
+  this->m_file << "\n";
+  for (const auto& record : records) {
+    this->m_file
+        << csv_field(record.fields[0])
+        << "," << this->m_bench
+        << "," << (record.fields.size() > 1 ? record.fields[1] : "")
+        << "," << record.run
+        << "," << record.variant
+        << "," << (record.outlier ? "true" : "false");
+    for (std::size_t col = 2; col < columns; ++col) {
+      this->m_file << "," << (col < record.fields.size() ? csv_field(record.fields[col]) : "");
+    }
+
+    this->m_file << "\n";
+  }
+
+  this->m_file.flush();
+
+  // the summary has different columns, so it is written to a separate file
+  const auto path = summary_path(this->m_path);
+  std::ofstream file{ path };
+  if (!file) {
+    throw std::runtime_error("failed to open output file '" + path + "'");
+  }
+
+  write_metadata(file);
+  file << "queue,bench,threads,variant,params,column,runs,median,mean,stddev,ci95_low,ci95_high,outlier_runs\n";
+  for (const auto& stats : summary) {
+    file
+        << csv_field(stats.queue)
+        << "," << this->m_bench
+        << "," << stats.threads
+        << "," << stats.variant
+        << "," << csv_field(stats.params)
+        << "," << stats.column
+        << "," << stats.count
+        << "," << format_stat(stats.median, "")
+        << "," << format_stat(stats.mean, "")
+        << "," << format_stat(stats.stddev, "")
+        << "," << format_stat(stats.ci_low, "")
+        << "," << format_stat(stats.ci_high, "")
+        << ",";
+    for (std::size_t idx = 0; idx < stats.outlier_runs.size(); ++idx) {
+      file << (idx == 0 ? "" : "/") << stats.outlier_runs[idx];
+    }
+
+    file << "\n";
+  }
+}
+
+void results_writer::write_json(const std::vector<record_t>& records, const std::vector<summary_t>& summary) {
+  auto& os = this->m_file;
+
+  os << "{\n  \"metadata\": {";
+  for (std::size_t idx = 0; idx < this->m_metadata.size(); ++idx) {
+    const auto& [key, value] = this->m_metadata[idx];
+    os << (idx == 0 ? "\n" : ",\n") << "    " << json_string(key) << ": " << json_string(value);
+  }
+
+  os << "\n  },\n  \"records\": [";
+  for (std::size_t idx = 0; idx < records.size(); ++idx) {
+    const auto& record = records[idx];
+    os
+        << (idx == 0 ? "\n" : ",\n")
+        << "    {\"queue\": " << json_string(record.fields[0])
+        << ", \"bench\": " << json_string(this->m_bench)
+        << ", \"threads\": " << (record.fields.size() > 1 ? json_field(record.fields[1]) : "null")
+        << ", \"run\": " << record.run
+        << ", \"variant\": " << record.variant
+        << ", \"outlier\": " << (record.outlier ? "true" : "false");
+    for (std::size_t col = 2; col < record.fields.size(); ++col) {
+      os << ", " << json_string(this->column_name(col)) << ": " << json_field(record.fields[col]);
+    }
+
+    os << "}";
+  }
+
+  os << "\n  ],\n  \"summary\": [";
+  for (std::size_t idx = 0; idx < summary.size(); ++idx) {
+    const auto& stats = summary[idx];
+    os
+        << (idx == 0 ? "\n" : ",\n")
+        << "    {\"queue\": " << json_string(stats.queue)
+        << ", \"bench\": " << json_string(this->m_bench)
+        << ", \"threads\": " << json_field(stats.threads)
+        << ", \"variant\": " << stats.variant
+        << ", \"params\": " << json_string(stats.params)
+        << ", \"column\": " << json_string(stats.column)
+        << ", \"runs\": " << stats.count
+        << ", \"median\": " << format_stat(stats.median, "null")
+        << ", \"mean\": " << format_stat(stats.mean, "null")
+        << ", \"stddev\": " << format_stat(stats.stddev, "null")
+        << ", \"ci95\": [" << format_stat(stats.ci_low, "null") << ", " << format_stat(stats.ci_high, "null") << "]"
+        << ", \"outlier_runs\": [";
+    for (std::size_t run = 0; run < stats.outlier_runs.size(); ++run) {
+      os << (run == 0 ? "" : ", ") << stats.outlier_runs[run];
+    }
+
+    os << "]}";
+  }
+
+  os << "\n  ]\n}\n";
+  os.flush();
+}
+
+/********** results_writer::line_buf ******************************************/
+
+results_writer::line_buf::int_type results_writer::line_buf::overflow(int_type ch) {
+  if (traits_type::eq_int_type(ch, traits_type::eof())) {
+    return traits_type::not_eof(ch);
+  }
+
+  if (traits_type::eq_int_type(this->m_out->sputc(traits_type::to_char_type(ch)), traits_type::eof())) {
+    return traits_type::eof();
+  }
+
+  if (traits_type::to_char_type(ch) == '\n') {
+    this->m_lines.push_back(std::move(this->m_line));
+    this->m_line.clear();
+  } else {
+    this->m_line += traits_type::to_char_type(ch);
+  }
+
+  return ch;
+}
+
+std::streamsize results_writer::line_buf::xsputn(const char* str, std::streamsize count) {
+  const auto res = this->m_out->sputn(str, count);
+
+  std::string_view written{ str, static_cast<std::size_t>(res) };
+  for (auto sep = written.find('\n'); sep != std::string_view::npos; sep = written.find('\n')) {
+    this->m_line += written.substr(0, sep);
+    this->m_lines.push_back(std::move(this->m_line));
+    this->m_line.clear();
+    written.remove_prefix(sep + 1);
+  }
+
+  this->m_line += written;
+  return res;
+}
+
+int results_writer::line_buf::sync() {
+  return this->m_out->pubsync();
+}
+}
@@ -1,25 +1,52 @@
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <bit>
 #include <concepts>
+#include <cstdint>
+#include <cstdlib>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <span>
 #include <string>
+#include <string_view>
 #include <stdexcept>
 #include <thread>
 #include <vector>
 
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
 #include "common.hpp"
+#include "histogram.hpp"
 
+#include "queues/coro/async_queue.hpp"
+#include "queues/coro/executor.hpp"
+#include "queues/evt/eventfd_queue.hpp"
 #include "queues/faa/faa_array.hpp"
+#include "queues/fc/flat_combining.hpp"
+#include "queues/hrq/hierarchical.hpp"
+#include "queues/kpq/kogan_petrank.hpp"
 #include "queues/lcr/lcrq.hpp"
 #include "queues/lsc/lscq.hpp"
 #include "queues/msc/michael_scott.hpp"
+#include "queues/mpsc/mpsc_segment.hpp"
+#include "queues/mtx/mutex_deque.hpp"
+#include "queues/shd/sharded.hpp"
+#include "queues/shm/shm_faa_array.hpp"
+#include "queues/spsc/spsc_ring.hpp"
+#include "queues/tkt/ticket_ring.hpp"
+#include "queues/tlq/two_lock.hpp"
+#include "sched/chase_lev.hpp"
+#include "sched/fork_join.hpp"
 
 #include "ymcqueue/queue.hpp"
 
 constexpr std::size_t THREAD_COUNT = 8;
 constexpr std::size_t COUNT = 100'000;
 
-constexpr auto EXPECTED = THREAD_COUNT * (COUNT * (COUNT - 1) / 2);
-
 template <typename Q, typename T>
 concept ConcurrentQueue =
     requires(Q queue, T* elem, std::size_t thread_id)
@@ -28,8 +55,53 @@ concept ConcurrentQueue =
   { queue.dequeue(thread_id) } -> std::same_as<T*>;
 };
 
+/** runs `producers` threads each enqueuing `COUNT` elements, which are evenly
+ *  dequeued by `consumers` threads */
 template <ConcurrentQueue<std::size_t> Q>
-bool test_queue(Q& queue);
+bool test_queue(Q& queue, std::size_t producers = THREAD_COUNT, std::size_t consumers = THREAD_COUNT);
+
+/** like `test_queue` above, but each producer thread passes all its `COUNT`
+ *  elements to `produce(elems, thread_id)`, which enqueues them in order */
+template <ConcurrentQueue<std::size_t> Q, typename P>
+bool test_queue(Q& queue, std::size_t producers, std::size_t consumers, P produce);
+
+/** enqueues and then dequeues `COUNT` elements on a single thread and checks
+ *  that `approx_size` is within `tolerance` of the actual size throughout */
+template <typename Q>
+bool test_approx_size(std::size_t tolerance = 0);
+
+/** checks that `approx_size` counts the elements of spliced segments, i.e.,
+ *  that their nodes' sequence numbers continue those of the tail */
+bool test_segment_approx_size();
+
+/** passes `COUNT` values from this process through a shared memory queue to a
+ *  forked child process and another `COUNT` values back */
+bool test_shm_queue();
+
+/** checks the arm/signal handshake of the eventfd queue, first step by step
+ *  and then with a consumer, which waits for the eventfd whenever it finds
+ *  the queue empty, so a lost signal lets it time out */
+bool test_eventfd_queue();
+
+/** runs `THREAD_COUNT` producer and consumer tasks passing `COUNT` elements
+ *  through a `coro::queue` on the single-threaded and on the thread pool
+ *  executor, checks their sums and that each task's thread id is that of the
+ *  executor thread actually running it after each suspension point */
+bool test_coro_queue();
+
+/** races the owner of a Chase-Lev deque popping elements against
+ *  `THREAD_COUNT - 1` thieves stealing them, checks that every element is
+ *  taken exactly once, and compares the results of the fork-join pool in
+ *  both modes with the sequential results */
+bool test_fork_join();
+
+/** checks the histogram's bucket boundaries at and around all powers of two
+ *  and its percentiles */
+bool test_histogram();
+
+/** runs `test_queue` with producers enqueuing their elements through
+ *  `enqueue_segment` (in segments of varying lengths) and `enqueue` */
+bool test_enqueue_segment();
 
 int main(int argc, const char* argv[]) {
   if (argc != 2) {
@@ -38,42 +110,123 @@ int main(int argc, const char* argv[]) {
 
   const auto queue_variant = std::string{ argv[1] };
 
+  // tests of the components other than the (in-process) queues
+  if (queue_variant == "shm") {
+    return !test_shm_queue();
+  }
+
+  if (queue_variant == "eventfd") {
+    return !test_eventfd_queue();
+  }
+
+  if (queue_variant == "async") {
+    return !test_coro_queue();
+  }
+
+  if (queue_variant == "forkjoin") {
+    return !test_fork_join();
+  }
+
+  if (queue_variant == "histogram") {
+    return !test_histogram();
+  }
+
   switch (bench::parse_queue_str(queue_variant)) {
     case bench::queue_type_t::FAA: {
       faa::queue<std::size_t> queue{ };
-      return !test_queue(queue);
+      return !(
+          test_queue(queue)
+          && test_enqueue_segment()
+          && test_approx_size<faa::queue<std::size_t>>()
+          && test_segment_approx_size()
+      );
     }
     case bench::queue_type_t::LCR: {
       lcr::queue<std::size_t> queue{ };
-      return !test_queue(queue);
+      return !(test_queue(queue) && test_approx_size<lcr::queue<std::size_t>>());
     }
     case bench::queue_type_t::MSC: {
       msc::queue<std::size_t> queue{ };
       return !test_queue(queue);
     }
     case bench::queue_type_t::SCQ2: {
+      // sizes are only counted in whole rings
       scq::cas2::queue<std::size_t> queue{ };
-      return !test_queue(queue);
+      return !(test_queue(queue) && test_approx_size<scq::cas2::queue<std::size_t>>(1024));
     }
     case bench::queue_type_t::SCQD: {
       scq::d::queue<std::size_t> queue{ };
-      return !test_queue(queue);
+      return !(test_queue(queue) && test_approx_size<scq::d::queue<std::size_t>>(1024));
     }
     case bench::queue_type_t::YMC: {
       ymc::queue<std::size_t> queue{ };
       return !test_queue(queue);
     }
+    case bench::queue_type_t::FC: {
+      fc::queue<std::size_t> queue{ };
+      return !test_queue(queue);
+    }
+    case bench::queue_type_t::MTX: {
+      mtx::queue<std::size_t> queue{ };
+      return !test_queue(queue);
+    }
+    case bench::queue_type_t::TLQ: {
+      tlq::queue<std::size_t> queue{ };
+      return !test_queue(queue);
+    }
+    case bench::queue_type_t::TKT: {
+      tkt::queue<std::size_t> queue{ };
+      return !test_queue(queue);
+    }
+    case bench::queue_type_t::SPSC: {
+      spsc::queue<std::size_t> queue{ };
+      return !test_queue(queue, 1, 1);
+    }
+    case bench::queue_type_t::MPSC: {
+      mpsc::queue<std::size_t> queue{ };
+      return !test_queue(queue, THREAD_COUNT, 1);
+    }
+    case bench::queue_type_t::KPQ: {
+      kpq::queue<std::size_t> queue{ };
+      return !test_queue(queue);
+    }
+    case bench::queue_type_t::SHD: {
+      shd::faa_queue<std::size_t> queue{ };
+      return !test_queue(queue);
+    }
+    case bench::queue_type_t::SHD_LCR: {
+      shd::lcr_queue<std::size_t> queue{ };
+      return !test_queue(queue);
+    }
+    case bench::queue_type_t::HRQ: {
+      // threads alternate between two nodes, so hand-offs from several nodes
+      // are covered on any machine
+      hrq::queue<std::size_t> queue{ std::vector<std::size_t>{ 0, 1 }, 2 * THREAD_COUNT };
+      return !test_queue(queue);
+    }
     default: throw std::runtime_error("unsupported queue variant");
   }
 }
 
 template <ConcurrentQueue<std::size_t> Q>
-bool test_queue(Q& queue) {
-  std::vector<std::size_t> thread_elements{ };
-  thread_elements.reserve(COUNT);
+bool test_queue(Q& queue, std::size_t producers, std::size_t consumers) {
+  return test_queue(queue, producers, consumers, [&](std::span<std::size_t* const> elems, std::size_t thread) {
+    for (const auto elem : elems) {
+      queue.enqueue(elem, thread);
+    }
+  });
+}
 
+template <ConcurrentQueue<std::size_t> Q, typename P>
+bool test_queue(Q& queue, std::size_t producers, std::size_t consumers, P produce) {
+  const auto expected = producers * (COUNT * (COUNT - 1) / 2);
+  const auto deqs_per_consumer = (producers * COUNT) / consumers;
+
+  std::vector<std::size_t> thread_elements(COUNT);
+  std::vector<std::size_t*> thread_pointers(COUNT);
   for (auto i = 0; i < COUNT; ++i) {
-    thread_elements.push_back(i);
+    thread_elements[i] = i;
+    thread_pointers[i] = &thread_elements[i];
   }
 
   const auto in_bounds = [&](const auto pointer) {
@@ -81,23 +234,22 @@ bool test_queue(Q& queue) {
   };
 
   std::vector<std::thread> threads{};
-  threads.reserve(THREAD_COUNT * 2);
+  threads.reserve(producers + consumers);
 
   std::atomic_bool start{ false };
   std::atomic_uint64_t sum{ 0 };
 
-  for (auto thread = 0; thread < THREAD_COUNT; ++thread) {
+  for (auto thread = 0; thread < producers; ++thread) {
     // producer thread
     threads.emplace_back([&, thread] {
       while (!start.load()) {}
-
-      for (auto op = 0; op < COUNT; ++op) {
-        queue.enqueue(&thread_elements.at(op), thread);
-      }
+      produce(std::span<std::size_t* const>{ thread_pointers }, thread);
     });
+  }
 
+  for (auto thread = 0; thread < consumers; ++thread) {
     // consumer thread
-    const auto deq_id = thread + THREAD_COUNT;
+    const auto deq_id = thread + producers;
     threads.emplace_back([&, deq_id] {
       uint64_t thread_sum = 0;
       uint64_t deq_count  = 0;
@@ -105,7 +257,7 @@ bool test_queue(Q& queue) {
       while (!start.load()) {}
 
       auto attempts = 0;
-      while (deq_count < COUNT) {
+      while (deq_count < deqs_per_consumer) {
         const auto res = queue.dequeue(deq_id);
         if (res != nullptr) {
           attempts = 0;
@@ -139,11 +291,587 @@ bool test_queue(Q& queue) {
   }
 
   const auto res = sum.load();
-  if (res != EXPECTED) {
-    std::cerr << "incorrect element sum, got " << sum << ", expected " << EXPECTED << std::endl;
+  if (res != expected) {
+    std::cerr << "incorrect element sum, got " << sum << ", expected " << expected << std::endl;
     return false;
   }
 
   std::cout << "test successful" << std::endl;
   return true;
 }
+
+bool test_enqueue_segment() {
+  using queue_t = faa::queue<std::size_t>;
+  constexpr auto SEGMENT_SIZE = queue_t::SEGMENT_SIZE;
+
+  // segments shorter than, equal to and longer than one node, each followed by
+  // a single regular enqueue into the (possibly partially filled) new tail
+  constexpr std::size_t SEGMENT_LENGTHS[] = {
+      1, SEGMENT_SIZE - 1, SEGMENT_SIZE, SEGMENT_SIZE + 1, 3 * SEGMENT_SIZE + 7
+  };
+
+  queue_t queue{ };
+  return test_queue(queue, THREAD_COUNT, THREAD_COUNT, [&](std::span<std::size_t* const> elems, std::size_t thread) {
+    std::size_t op = 0;
+    for (auto round = thread; op < elems.size(); ++round) {
+      const auto length = std::min(SEGMENT_LENGTHS[round % std::size(SEGMENT_LENGTHS)], elems.size() - op);
+      queue.enqueue_segment(elems.subspan(op, length), thread);
+      op += length;
+
+      if (op < elems.size()) {
+        queue.enqueue(elems[op], thread);
+        op += 1;
+      }
+    }
+  });
+}
+
+template <typename Q>
+bool test_approx_size(std::size_t tolerance) {
+  // checks the size after every `STEP` operations, which is coprime to the
+  // sizes of the nodes or rings, so it is checked at varying offsets in them
+  constexpr std::size_t STEP = 999;
+
+  Q queue{ };
+  std::vector<std::size_t> elements(COUNT);
+
+  const auto check_size = [&](std::size_t expected) {
+    const auto size = queue.approx_size(0);
+    const auto diff = size > expected ? size - expected : expected - size;
+    if (diff > tolerance) {
+      std::cerr << "incorrect approximate size, got " << size << ", expected " << expected << std::endl;
+      return false;
+    }
+
+    return true;
+  };
+
+  if (!check_size(0)) {
+    return false;
+  }
+
+  for (std::size_t op = 0; op < COUNT; ++op) {
+    queue.enqueue(&elements[op], 0);
+    if ((op + 1) % STEP == 0 && !check_size(op + 1)) {
+      return false;
+    }
+  }
+
+  for (std::size_t op = 0; op < COUNT; ++op) {
+    if (queue.dequeue(0) != &elements[op]) {
+      std::cerr << "element dequeued out of order" << std::endl;
+      return false;
+    }
+
+    if ((op + 1) % STEP == 0 && !check_size(COUNT - op - 1)) {
+      return false;
+    }
+  }
+
+  if (!check_size(0)) {
+    return false;
+  }
+
+  std::cout << "size test successful" << std::endl;
+  return true;
+}
+
+bool test_segment_approx_size() {
+  using queue_t = faa::queue<std::size_t>;
+  constexpr auto SEGMENT_SIZE = queue_t::SEGMENT_SIZE;
+  // the first node is filled exactly, since the free slots of a tail node
+  // behind which a segment is spliced are counted as well
+  constexpr auto ENQUEUES = SEGMENT_SIZE;
+  constexpr auto SEGMENT_LENGTH = 2 * SEGMENT_SIZE + 7;
+
+  queue_t queue{ };
+  std::vector<std::size_t> elements(ENQUEUES + SEGMENT_SIZE + 2 * SEGMENT_LENGTH);
+  std::vector<std::size_t*> pointers(elements.size());
+  for (std::size_t idx = 0; idx < elements.size(); ++idx) {
+    pointers[idx] = &elements[idx];
+  }
+
+  for (std::size_t op = 0; op < ENQUEUES; ++op) {
+    queue.enqueue(pointers[op], 0);
+  }
+
+  queue.enqueue_segment(std::span{ pointers }.subspan(ENQUEUES, SEGMENT_LENGTH), 0);
+  auto expected = ENQUEUES + SEGMENT_LENGTH;
+  if (queue.approx_size(0) != expected) {
+    std::cerr << "incorrect size after segment, got " << queue.approx_size(0) << ", expected " << expected << std::endl;
+    return false;
+  }
+
+  // the remaining slots of the partially filled last node are filled by
+  // regular enqueues, followed by another segment
+  const auto fill = SEGMENT_SIZE - SEGMENT_LENGTH % SEGMENT_SIZE;
+  for (std::size_t op = 0; op < fill; ++op) {
+    queue.enqueue(pointers[expected + op], 0);
+  }
+
+  expected += fill;
+  queue.enqueue_segment(std::span{ pointers }.subspan(expected, SEGMENT_LENGTH), 0);
+  expected += SEGMENT_LENGTH;
+  if (queue.approx_size(0) != expected) {
+    std::cerr << "incorrect size after second segment, got " << queue.approx_size(0) << ", expected " << expected << std::endl;
+    return false;
+  }
+
+  for (std::size_t op = 0; op < expected; ++op) {
+    if (queue.dequeue(0) != pointers[op]) {
+      std::cerr << "segment element dequeued out of order" << std::endl;
+      return false;
+    }
+  }
+
+  if (queue.approx_size(0) != 0) {
+    std::cerr << "incorrect size after all elements were dequeued" << std::endl;
+    return false;
+  }
+
+  std::cout << "segment size test successful" << std::endl;
+  return true;
+}
+
+bool test_shm_queue() {
+  const auto name = "/lfqueue-test-" + std::to_string(::getpid());
+  // the values span several segments in both directions, so segments are
+  // allocated and reclaimed across both processes
+  const auto segments = 2 * COUNT / shm::queue::SEGMENT_SIZE + 64;
+  shm::queue queue{ name, segments };
+
+  for (std::uint64_t value = 1; value <= COUNT; ++value) {
+    queue.enqueue(value);
+  }
+
+  const auto pid = ::fork();
+  if (pid == -1) {
+    shm::queue::unlink(name);
+    throw std::runtime_error("failed to fork process");
+  }
+
+  if (pid == 0) {
+    // the child attaches at its own address and checks the FIFO order of the
+    // parent's values before enqueuing its own
+    auto success = true;
+    try {
+      shm::queue child_queue{ name };
+      for (std::uint64_t value = 1; value <= COUNT; ++value) {
+        if (child_queue.dequeue() != value) {
+          success = false;
+          break;
+        }
+      }
+
+      for (std::uint64_t value = COUNT + 1; success && value <= 2 * COUNT; ++value) {
+        child_queue.enqueue(value);
+      }
+    } catch (const std::exception& e) {
+      std::cerr << "child process failed: " << e.what() << std::endl;
+      success = false;
+    }
+
+    ::_exit(success ? EXIT_SUCCESS : EXIT_FAILURE);
+  }
+
+  int status;
+  const auto waited = ::waitpid(pid, &status, 0) != -1;
+  shm::queue::unlink(name);
+  if (!waited || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+    std::cerr << "child process failed to dequeue the parent's values in order" << std::endl;
+    return false;
+  }
+
+  for (std::uint64_t value = COUNT + 1; value <= 2 * COUNT; ++value) {
+    if (queue.dequeue() != value) {
+      std::cerr << "child's value dequeued out of order" << std::endl;
+      return false;
+    }
+  }
+
+  if (queue.dequeue() != 0) {
+    std::cerr << "shared memory queue not empty after all values were dequeued" << std::endl;
+    return false;
+  }
+
+  std::cout << "shm test successful" << std::endl;
+  return true;
+}
+
+bool test_eventfd_queue() {
+  // the time after which a waiting consumer assumes a lost signal
+  constexpr int TIMEOUT_MS = 10'000;
+
+  std::vector<std::size_t> elements(COUNT);
+  for (auto i = 0; i < COUNT; ++i) {
+    elements[i] = i;
+  }
+
+  {
+    evt::queue<faa::queue<std::size_t>> queue{ };
+    const auto readable = [&] {
+      pollfd pfd{ queue.fd(), POLLIN, 0 };
+      return ::poll(&pfd, 1, 0) == 1;
+    };
+
+    // only the first enqueue after arming signals, all others are coalesced
+    const auto armed_steps =
+        queue.arm(0) == nullptr
+        && !readable()
+        && (queue.enqueue(&elements[0], 1), queue.signals() == 1)
+        && readable()
+        && (queue.enqueue(&elements[1], 1), queue.signals() == 1);
+
+    // arming a non-empty queue returns the next element and does not signal
+    queue.clear();
+    const auto non_empty_steps =
+        armed_steps
+        && !readable()
+        && queue.arm(0) == &elements[0]
+        && (queue.enqueue(&elements[2], 1), queue.signals() == 1)
+        && !readable();
+
+    if (!non_empty_steps) {
+      std::cerr << "eventfd queue signalled incorrectly" << std::endl;
+      return false;
+    }
+  }
+
+  evt::queue<faa::queue<std::size_t>> queue{ };
+  std::atomic_bool timed_out{ false };
+
+  std::thread producer{ [&] {
+    for (auto op = 0; op < COUNT && !timed_out.load(); ++op) {
+      queue.enqueue(&elements[op], 0);
+      // lets the consumer catch up now and then, so it arms the queue often
+      if (op % 64 == 0) {
+        std::this_thread::yield();
+      }
+    }
+  } };
+
+  std::uint64_t sum = 0;
+  std::size_t deq_count = 0;
+  while (deq_count < COUNT) {
+    auto elem = queue.dequeue(1);
+    if (elem == nullptr && (elem = queue.arm(1)) == nullptr) {
+      pollfd pfd{ queue.fd(), POLLIN, 0 };
+      if (::poll(&pfd, 1, TIMEOUT_MS) != 1) {
+        timed_out.store(true);
+        break;
+      }
+
+      queue.clear();
+      continue;
+    }
+
+    sum += *elem;
+    deq_count += 1;
+  }
+
+  producer.join();
+  if (timed_out.load()) {
+    std::cerr << "consumer timed out waiting for a signal (lost wake-up)" << std::endl;
+    return false;
+  }
+
+  const auto expected = COUNT * (COUNT - 1) / 2;
+  if (sum != expected) {
+    std::cerr << "incorrect eventfd element sum, got " << sum << ", expected " << expected << std::endl;
+    return false;
+  }
+
+  std::cout << "eventfd test successful (" << queue.signals() << " signals)" << std::endl;
+  return true;
+}
+
+bool test_coro_queue() {
+  using queue_t = coro::queue<faa::queue<std::size_t>>;
+  // the number of pushes after which a producer yields
+  constexpr std::size_t YIELD_INTERVAL = 64;
+
+  const auto enqs_per_producer = COUNT / THREAD_COUNT;
+  const auto expected = COUNT * (COUNT - 1) / 2;
+
+  std::vector<std::size_t> elements(COUNT);
+  for (auto i = 0; i < COUNT; ++i) {
+    elements[i] = i;
+  }
+
+  // the ids of the executor threads, which are all set before any task runs
+  std::vector<std::thread::id> executor_threads(THREAD_COUNT);
+  std::atomic_bool wrong_thread{ false };
+  std::atomic_uint64_t sum{ 0 };
+
+  const auto check_thread = [&](std::size_t thread_id) {
+    if (thread_id >= THREAD_COUNT || executor_threads[thread_id] != std::this_thread::get_id()) {
+      wrong_thread.store(true);
+    }
+  };
+
+  const auto producer_task = [&](auto& executor, queue_t& queue, std::size_t producer) -> coro::task {
+    const auto& thread_id = co_await coro::this_thread_id();
+    for (std::size_t op = 0; op < enqs_per_producer; ++op) {
+      check_thread(thread_id);
+      queue.push(&elements[producer * enqs_per_producer + op], thread_id);
+      if (op % YIELD_INTERVAL == YIELD_INTERVAL - 1) {
+        co_await executor.yield();
+      }
+    }
+  };
+
+  const auto consumer_task = [&](queue_t& queue) -> coro::task {
+    const auto& thread_id = co_await coro::this_thread_id();
+    std::uint64_t task_sum = 0;
+    for (std::size_t op = 0; op < enqs_per_producer; ++op) {
+      const auto elem = co_await queue.pop(thread_id);
+      check_thread(thread_id);
+      task_sum += *elem;
+    }
+
+    sum.fetch_add(task_sum);
+  };
+
+  // spawns all consumer tasks first, so they start out waiting
+  const auto spawn_tasks = [&](auto& executor, queue_t& queue) {
+    for (std::size_t consumer = 0; consumer < THREAD_COUNT; ++consumer) {
+      executor.spawn(consumer_task(queue));
+    }
+
+    for (std::size_t producer = 0; producer < THREAD_COUNT; ++producer) {
+      executor.spawn(producer_task(executor, queue, producer));
+    }
+  };
+
+  const auto check_results = [&](std::string_view executor_name, std::size_t pending) {
+    if (pending != 0 || wrong_thread.load()) {
+      std::cerr << executor_name << " executor ran a task with a wrong thread id or stalled" << std::endl;
+      return false;
+    }
+
+    if (sum.load() != expected) {
+      std::cerr << "incorrect " << executor_name << " element sum, got " << sum.load() << ", expected " << expected << std::endl;
+      return false;
+    }
+
+    sum.store(0);
+    return true;
+  };
+
+  {
+    queue_t queue{ };
+    coro::single_thread_executor executor{ };
+    spawn_tasks(executor, queue);
+    executor_threads[0] = std::this_thread::get_id();
+    executor.run();
+
+    if (!check_results("single-threaded", executor.pending())) {
+      return false;
+    }
+  }
+
+  queue_t queue{ };
+  coro::thread_pool_executor executor{ THREAD_COUNT };
+  spawn_tasks(executor, queue);
+
+  std::vector<std::thread> threads{};
+  threads.reserve(THREAD_COUNT);
+  std::atomic_size_t ready{ 0 };
+
+  for (std::size_t thread = 0; thread < THREAD_COUNT; ++thread) {
+    threads.emplace_back([&, thread] {
+      executor_threads[thread] = std::this_thread::get_id();
+      ready.fetch_add(1);
+      while (ready.load() < THREAD_COUNT) {}
+
+      executor.run(thread);
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  if (!check_results("thread pool", 0)) {
+    return false;
+  }
+
+  std::cout << "async test successful" << std::endl;
+  return true;
+}
+
+bool test_fork_join() {
+  // small enough, so the deque is often full or (almost) empty
+  constexpr std::size_t DEQUE_CAPACITY = 64;
+
+  std::vector<std::size_t> elements(COUNT);
+  std::vector<std::atomic_uint32_t> taken(COUNT);
+  for (auto i = 0; i < COUNT; ++i) {
+    elements[i] = i;
+  }
+
+  {
+    sched::chase_lev_deque<std::size_t> deque{ DEQUE_CAPACITY };
+    std::atomic_bool start{ false };
+    std::atomic_bool done{ false };
+
+    const auto take = [&](std::size_t* elem) {
+      taken[*elem].fetch_add(1);
+    };
+
+    std::vector<std::thread> thieves{};
+    thieves.reserve(THREAD_COUNT - 1);
+    for (auto thread = 1; thread < THREAD_COUNT; ++thread) {
+      thieves.emplace_back([&] {
+        while (!start.load()) {}
+
+        while (!done.load()) {
+          if (const auto elem = deque.steal(); elem != nullptr) {
+            take(elem);
+          }
+        }
+      });
+    }
+
+    start.store(true);
+
+    // the owner pops after every other push and whenever the deque is full,
+    // so its pops race with the thieves' steals for the last elements
+    for (auto op = 0; op < COUNT; ++op) {
+      while (!deque.push(&elements[op])) {
+        if (const auto elem = deque.pop(); elem != nullptr) {
+          take(elem);
+        }
+      }
+
+      if (op % 2 == 1) {
+        if (const auto elem = deque.pop(); elem != nullptr) {
+          take(elem);
+        }
+      }
+    }
+
+    // a failed pop means the deque is empty, the last element may have been
+    // stolen concurrently
+    while (const auto elem = deque.pop()) {
+      take(elem);
+    }
+
+    done.store(true);
+    for (auto& thread : thieves) {
+      thread.join();
+    }
+
+    for (auto i = 0; i < COUNT; ++i) {
+      if (taken[i].load() != 1) {
+        std::cerr << "deque element " << i << " taken " << taken[i].load() << " times" << std::endl;
+        return false;
+      }
+    }
+  }
+
+  constexpr auto workloads = std::to_array({
+      sched::workload_t::FIB, sched::workload_t::NQUEENS, sched::workload_t::TREE
+  });
+  constexpr auto modes = std::to_array({ sched::mode_t::SHARED, sched::mode_t::STEALING });
+
+  for (const auto workload : workloads) {
+    const auto expected = sched::expected_result(workload);
+    for (const auto mode : modes) {
+      faa::queue<std::size_t> queue{ };
+      sched::fork_join_pool pool{ THREAD_COUNT, mode };
+      {
+        auto injector = faa::queue_ref<std::size_t>{ queue, 0 };
+        pool.inject(injector, sched::make_root_job(workload));
+      }
+
+      std::vector<std::thread> threads{};
+      threads.reserve(THREAD_COUNT);
+      for (auto thread = 0; thread < THREAD_COUNT; ++thread) {
+        threads.emplace_back([&, thread] {
+          auto queue_ref = faa::queue_ref<std::size_t>{ queue, static_cast<std::size_t>(thread) };
+          pool.work(queue_ref, thread);
+        });
+      }
+
+      for (auto& thread : threads) {
+        thread.join();
+      }
+
+      if (pool.result() != expected) {
+        std::cerr
+            << "fork-join result of " << sched::display_str(workload)
+            << " (" << sched::display_str(mode) << ") is " << pool.result()
+            << ", expected " << expected << std::endl;
+        return false;
+      }
+    }
+  }
+
+  std::cout << "fork-join test successful" << std::endl;
+  return true;
+}
+
+bool test_histogram() {
+  constexpr auto SUB_BITS = bench::histogram::SUB_BITS;
+
+  // the highest value in the bucket of `value`, i.e., all bits below the
+  // `SUB_BITS` bits following the most significant one are set
+  const auto highest_equivalent = [](std::uint64_t value) {
+    if (value < (std::uint64_t{ 1 } << SUB_BITS)) {
+      return value;
+    }
+
+    const auto shift = static_cast<std::size_t>(std::bit_width(value)) - 1 - SUB_BITS;
+    return value | ((std::uint64_t{ 1 } << shift) - 1);
+  };
+
+  std::vector<std::uint64_t> values{ UINT64_MAX - 1, UINT64_MAX };
+  for (std::size_t bit = 0; bit < 64; ++bit) {
+    const auto power = std::uint64_t{ 1 } << bit;
+    values.insert(values.end(), { power - 1, power, power + 1 });
+  }
+
+  auto hist = std::make_unique<bench::histogram>();
+  for (const auto value : values) {
+    // the lowest value is reported as the highest equivalent value of its
+    // bucket, unless that exceeds the maximum
+    hist->reset();
+    hist->record(value);
+    hist->record(UINT64_MAX);
+    if (hist->percentile(0.0) != highest_equivalent(value)) {
+      std::cerr
+          << "value " << value << " reported as " << hist->percentile(0.0)
+          << ", expected " << highest_equivalent(value) << std::endl;
+      return false;
+    }
+
+    hist->reset();
+    hist->record(value);
+    if (hist->percentile(100.0) != value || hist->max() != value) {
+      std::cerr << "single value " << value << " not reported exactly" << std::endl;
+      return false;
+    }
+  }
+
+  // values 1 to 100 are counted exactly up to 63, and with a bucket width of
+  // two up to 127, with the highest value clamped to the maximum
+  hist->reset();
+  for (std::uint64_t value = 1; value <= 100; ++value) {
+    hist->record(value);
+  }
+
+  if (
+      hist->count() != 100
+      || hist->percentile(0.0) != 1
+      || hist->percentile(50.0) != 50
+      || hist->percentile(90.0) != 91
+      || hist->percentile(100.0) != 100
+  ) {
+    std::cerr << "incorrect percentiles of the values 1 to 100" << std::endl;
+    return false;
+  }
+
+  std::cout << "histogram test successful" << std::endl;
+  return true;
+}